@@ -261,6 +261,36 @@ DEEGEN_DEFINE_LIB_FUNC(debug_setupvalue)
     ThrowError("Library function 'debug.setupvalue' is not implemented yet!");
 }
 
+// debug.structurestats -- non-standard extension
+//
+// debug.structurestats ()
+// Returns a table with statistics about the hidden class (Structure) transition tree of the VM, with the following fields:
+// 'structures' (number of Structures created), 'transitions' (number of transition edges created), 'maxfanout' (the maximum
+// number of outgoing transitions of a single Structure), 'dictionaries' (number of objects that transitioned to dictionary mode),
+// and 'fanoutdictionaries' (number of dictionary transitions caused by the transition fan-out guard).
+//
+DEEGEN_DEFINE_LIB_FUNC(debug_structurestats)
+{
+    VM* vm = VM::GetActiveVMForCurrentThread();
+    VM::StructureStats stats = vm->GetStructureStats();
+
+    HeapPtr<TableObject> tbl = TableObject::CreateEmptyTableObject(vm, 5 /*inlineCapacity*/, 0 /*initialButterflyArrayPartCapacity*/);
+    auto insertField = [&](const char* name, uint64_t value)
+    {
+        UserHeapPointer<HeapString> hs = vm->CreateStringObjectFromRawString(name, static_cast<uint32_t>(strlen(name)));
+        PutByIdICInfo icInfo;
+        TableObject::PreparePutById(tbl, hs, icInfo /*out*/);
+        TableObject::PutById(tbl, hs.As<void>(), TValue::Create<tDouble>(static_cast<double>(value)), icInfo);
+    };
+    insertField("structures", stats.m_numStructuresCreated);
+    insertField("transitions", stats.m_numTransitionsCreated);
+    insertField("maxfanout", stats.m_maxTransitionFanOut);
+    insertField("dictionaries", stats.m_numDictionaryConversions);
+    insertField("fanoutdictionaries", stats.m_numDictionaryConversionsDueToFanOut);
+
+    Return(TValue::Create<tTable>(tbl));
+}
+
 // debug.traceback -- https://www.lua.org/manual/5.1/manual.html#pdf-debug.traceback
 //
 // debug.traceback ([thread,] [message [, level]])
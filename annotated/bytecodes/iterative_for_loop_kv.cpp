@@ -33,6 +33,23 @@ static void NO_RETURN ValidateIsNextAndBranchImpl(TValue* base)
         static_assert(sizeof(TableObjectIterator) == 8);
         ConstructInPlace(reinterpret_cast<TableObjectIterator*>(base + 2));
     }
+    else
+    {
+        // Similarly, the for-loop can be specialized to a table-array-iteration loop if the followings are true:
+        //   1. base[0] is the true iterator function returned by 'ipairs'
+        //   2. base[1] is a table
+        //   3. base[2] is a double (the control variable, which is the last visited index)
+        //
+        // In this case base[2] is kept as-is, since it is exactly the state of the iteration
+        //
+        if (base[0].m_value == VM_GetLibFunctionObject<VM::LibFn::BaseIPairsIter>().m_value)
+        {
+            if (base[1].Is<tTable>() && base[2].Is<tDouble>())
+            {
+                base[0] = VM_GetLibFunctionObject<VM::LibFn::BaseIPairsIterValidationOk>();
+            }
+        }
+    }
 
     ReturnAndBranch();
 }
@@ -113,6 +130,39 @@ static void NO_RETURN KVLoopIterImpl(TValue* base, uint8_t numRets)
             ReturnAndBranch();
         }
     }
+    else if (likely(base[0].m_value == VM_GetLibFunctionObject<VM::LibFn::BaseIPairsIterValidationOk>().m_value))
+    {
+        // Same logic as base_ipairs_iterator, but without the call
+        //
+        HeapPtr<TableObject> table = base[1].As<tTable>();
+        int32_t idx = static_cast<int32_t>(base[2].As<tDouble>());
+        idx++;
+
+        GetByIntegerIndexICInfo icInfo;
+        TableObject::PrepareGetByIntegerIndex(table, icInfo /*out*/);
+        TValue res = TableObject::GetByIntegerIndex(table, idx, icInfo);
+        assert(1 <= numRets && numRets <= 2);
+        if (unlikely(res.Is<tNil>()))
+        {
+            base[3] = TValue::Create<tNil>();
+            if (numRets == 2)
+            {
+                base[4] = TValue::Create<tNil>();
+            }
+            Return();
+        }
+        else
+        {
+            TValue key = TValue::Create<tDouble>(idx);
+            base[2] = key;
+            base[3] = key;
+            if (numRets == 2)
+            {
+                base[4] = res;
+            }
+            ReturnAndBranch();
+        }
+    }
     else
     {
         EnterSlowPath<KVLoopIterNotNextFunctionSlowPath>(base);
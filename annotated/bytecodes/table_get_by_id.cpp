@@ -3,6 +3,7 @@
 #include "api_inline_cache.h"
 
 #include "runtime_utils.h"
+#include "table_get_by_id_ic.h"
 
 static void NO_RETURN TableGetByIdMetamethodCallContinuation(TValue /*base*/, TValue /*tvIndex*/)
 {
@@ -70,24 +71,14 @@ static void NO_RETURN HandleMetatableSlowPath(TValue /*bc_base*/, TValue tvIndex
     assert(tvIndex.Is<tString>());
     HeapPtr<HeapString> index = tvIndex.As<tString>();
 
-    HeapPtr<TableObject> tableObj = base.As<tTable>();
-    GetByIdICInfo icInfo;
-    TableObject::PrepareGetById(tableObj, UserHeapPointer<HeapString> { index }, icInfo /*out*/);
-    TValue result = TableObject::GetById(tableObj, index, icInfo);
-    if (unlikely(icInfo.m_mayHaveMetatable && result.Is<tNil>()))
+    auto [result, resultKind] = TableGetByIdWithoutInlineCache(base.As<tTable>(), index);
+    if (unlikely(resultKind == TableGetByIdIcResultKind::MayHaveMetatable && result.Is<tNil>()))
     {
         EnterSlowPath<CheckMetatableSlowPath>(base);
     }
     Return(result);
 }
 
-enum class TableGetByIdIcResultKind
-{
-    NotTable,           // The base object is not a table
-    MayHaveMetatable,   // The base object is a table that may have metatable
-    NoMetatable         // The base object is a table that is guaranteed to have no metatable
-};
-
 static void NO_RETURN TableGetByIdImpl(TValue base, TValue tvIndex)
 {
     assert(tvIndex.Is<tString>());
@@ -99,63 +90,8 @@ static void NO_RETURN TableGetByIdImpl(TValue base, TValue tvIndex)
     if (likely(base.Is<tHeapEntity>()))
     {
         HeapPtr<TableObject> heapEntity = reinterpret_cast<HeapPtr<TableObject>>(base.As<tHeapEntity>());
-        ICHandler* ic = MakeInlineCache();
-        ic->AddKey(heapEntity->m_hiddenClass.m_value).SpecifyImpossibleValue(0);
-        ic->FuseICIntoInterpreterOpcode();
-
         using ResKind = TableGetByIdIcResultKind;
-        auto [result, resultKind] = ic->Body([ic, heapEntity, index]() -> std::pair<TValue, ResKind>
-        {
-            // If the heapEntity isn't a table, there's nothing we can do here
-            //
-            if (unlikely(heapEntity->m_type != HeapEntityType::Table))
-            {
-                return std::make_pair(TValue(), ResKind::NotTable);
-            }
-
-            GetByIdICInfo c_info;
-            TableObject::PrepareGetById(heapEntity, UserHeapPointer<HeapString> { index }, c_info /*out*/);
-            ResKind c_resKind = c_info.m_mayHaveMetatable ? ResKind::MayHaveMetatable : ResKind::NoMetatable;
-            switch (c_info.m_icKind)
-            {
-            case GetByIdICInfo::ICKind::UncachableDictionary:
-            {
-                assert(false && "unimplemented");
-                __builtin_unreachable();
-            }
-            case GetByIdICInfo::ICKind::MustBeNil:
-            {
-                return ic->Effect([c_resKind] {
-                    IcSpecializeValueFullCoverage(c_resKind, ResKind::MayHaveMetatable, ResKind::NoMetatable);
-                    return std::make_pair(TValue::Create<tNil>(), c_resKind);
-                });
-            }
-            case GetByIdICInfo::ICKind::MustBeNilButUncacheable:
-            {
-                return std::make_pair(TValue::Create<tNil>(), c_resKind);
-            }
-            case GetByIdICInfo::ICKind::InlinedStorage:
-            {
-                int32_t c_slot = c_info.m_slot;
-                return ic->Effect([heapEntity, c_slot, c_resKind] {
-                    IcSpecializeValueFullCoverage(c_resKind, ResKind::MayHaveMetatable, ResKind::NoMetatable);
-                    IcSpecifyCaptureValueRange(c_slot, 0, 255);
-                    TValue res = TCGet(heapEntity->m_inlineStorage[c_slot]);
-                    return std::make_pair(res, c_resKind);
-                });
-            }
-            case GetByIdICInfo::ICKind::OutlinedStorage:
-            {
-                int32_t c_slot = c_info.m_slot;
-                return ic->Effect([heapEntity, c_slot, c_resKind] {
-                    IcSpecializeValueFullCoverage(c_resKind, ResKind::MayHaveMetatable, ResKind::NoMetatable);
-                    IcSpecifyCaptureValueRange(c_slot, Butterfly::x_namedPropOrdinalRangeMin, Butterfly::x_namedPropOrdinalRangeMax);
-                    TValue res = heapEntity->m_butterfly->GetNamedProperty(c_slot);
-                    return std::make_pair(res, c_resKind);
-                });
-            }
-            }   /* switch icKind */
-        });
+        auto [result, resultKind] = TableGetByIdWithInlineCache(heapEntity, index);
 
         switch (resultKind)
         {
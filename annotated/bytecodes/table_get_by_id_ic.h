@@ -0,0 +1,121 @@
+#pragma once
+
+#include "api_inline_cache.h"
+#include "runtime_utils.h"
+
+// The inline-cached 'base.index' lookup (where 'index' is a constant string) shared by TableGetById and TableGetMethod
+//
+
+enum class TableGetByIdIcResultKind
+{
+    NotTable,           // The base object is not a table
+    MayHaveMetatable,   // The base object is a table that may have metatable
+    NoMetatable         // The base object is a table that is guaranteed to have no metatable
+};
+
+// Look up 'index' in 'heapEntity' through an inline cache keyed on the hidden class of 'heapEntity'.
+// This creates the inline cache of the bytecode, so it must be called at most once per bytecode.
+//
+// The returned result is only meaningful if the result kind is not NotTable. If the result kind is MayHaveMetatable
+// and the result is nil, the caller must check the metatable of 'heapEntity' for an '__index' metamethod.
+//
+static std::pair<TValue, TableGetByIdIcResultKind> WARN_UNUSED ALWAYS_INLINE TableGetByIdWithInlineCache(HeapPtr<TableObject> heapEntity, HeapPtr<HeapString> index)
+{
+    ICHandler* ic = MakeInlineCache();
+    ic->AddKey(heapEntity->m_hiddenClass.m_value).SpecifyImpossibleValue(0);
+    ic->FuseICIntoInterpreterOpcode();
+
+    using ResKind = TableGetByIdIcResultKind;
+    return ic->Body([ic, heapEntity, index]() -> std::pair<TValue, ResKind>
+    {
+        // If the heapEntity isn't a table, there's nothing we can do here
+        //
+        if (unlikely(heapEntity->m_type != HeapEntityType::Table))
+        {
+            return std::make_pair(TValue(), ResKind::NotTable);
+        }
+
+        GetByIdICInfo c_info;
+        TableObject::PrepareGetByIdWithMegamorphicCache(heapEntity, UserHeapPointer<HeapString> { index }, c_info /*out*/);
+        ResKind c_resKind = c_info.m_mayHaveMetatable ? ResKind::MayHaveMetatable : ResKind::NoMetatable;
+        switch (c_info.m_icKind)
+        {
+        case GetByIdICInfo::ICKind::UncachableDictionary:
+        {
+            // The VM never transits a table to UncacheableDictionary yet, and PrepareGetById does not support it either
+            //
+            assert(false && "unimplemented");
+            __builtin_unreachable();
+        }
+        case GetByIdICInfo::ICKind::MustBeNil:
+        {
+            // The common OOP pattern: the property is not in the object, but in the '__index' table of its metatable
+            //
+            GetByIdIndexTableICInfo c_mtInfo;
+            if (c_info.m_mayHaveMetatable && TableObject::TryPrepareGetByIdFromIndexTable(heapEntity, UserHeapPointer<HeapString> { index }, c_mtInfo /*out*/))
+            {
+                TValue c_mt = c_mtInfo.m_metatable;
+                SystemHeapPointer<void> c_mtHiddenClass = c_mtInfo.m_metatableHiddenClass;
+                GetByIdICInfo::ICKind c_mtIndexSlotKind = c_mtInfo.m_metatableIndexSlotKind;
+                int32_t c_mtIndexSlot = c_mtInfo.m_metatableIndexSlot;
+                TValue c_indexTable = c_mtInfo.m_indexTable;
+                SystemHeapPointer<void> c_indexTableHiddenClass = c_mtInfo.m_indexTableHiddenClass;
+                GetByIdICInfo::ICKind c_propKind = c_mtInfo.m_propertySlotKind;
+                int32_t c_propSlot = c_mtInfo.m_propertySlot;
+                return ic->Effect([c_mt, c_mtHiddenClass, c_mtIndexSlotKind, c_mtIndexSlot, c_indexTable, c_indexTableHiddenClass, c_propKind, c_propSlot] {
+                    IcSpecializeValueFullCoverage(c_mtIndexSlotKind, GetByIdICInfo::ICKind::InlinedStorage, GetByIdICInfo::ICKind::OutlinedStorage);
+                    IcSpecializeValueFullCoverage(c_propKind, GetByIdICInfo::ICKind::InlinedStorage, GetByIdICInfo::ICKind::OutlinedStorage);
+                    IcSpecifyCaptureValueRange(c_mtIndexSlot, Butterfly::x_namedPropOrdinalRangeMin, 255);
+                    IcSpecifyCaptureValueRange(c_propSlot, Butterfly::x_namedPropOrdinalRangeMin, 255);
+                    IcSpecifyCaptureAs2GBPointerNotNull(c_mtHiddenClass);
+                    IcSpecifyCaptureAs2GBPointerNotNull(c_indexTableHiddenClass);
+                    // If the guards fail or the result is nil, the caller falls back to the generic metatable slow path
+                    //
+                    TValue res = TableObject::GetByIdFromIndexTableWithGuards(c_mt, c_mtHiddenClass, c_mtIndexSlotKind, c_mtIndexSlot,
+                                                                              c_indexTable, c_indexTableHiddenClass, c_propKind, c_propSlot);
+                    return std::make_pair(res, ResKind::MayHaveMetatable);
+                });
+            }
+            return ic->Effect([c_resKind] {
+                IcSpecializeValueFullCoverage(c_resKind, ResKind::MayHaveMetatable, ResKind::NoMetatable);
+                return std::make_pair(TValue::Create<tNil>(), c_resKind);
+            });
+        }
+        case GetByIdICInfo::ICKind::MustBeNilButUncacheable:
+        {
+            return std::make_pair(TValue::Create<tNil>(), c_resKind);
+        }
+        case GetByIdICInfo::ICKind::InlinedStorage:
+        {
+            int32_t c_slot = c_info.m_slot;
+            return ic->Effect([heapEntity, c_slot, c_resKind] {
+                IcSpecializeValueFullCoverage(c_resKind, ResKind::MayHaveMetatable, ResKind::NoMetatable);
+                IcSpecifyCaptureValueRange(c_slot, 0, 255);
+                TValue res = TCGet(heapEntity->m_inlineStorage[c_slot]);
+                return std::make_pair(res, c_resKind);
+            });
+        }
+        case GetByIdICInfo::ICKind::OutlinedStorage:
+        {
+            int32_t c_slot = c_info.m_slot;
+            return ic->Effect([heapEntity, c_slot, c_resKind] {
+                IcSpecializeValueFullCoverage(c_resKind, ResKind::MayHaveMetatable, ResKind::NoMetatable);
+                IcSpecifyCaptureValueRange(c_slot, Butterfly::x_namedPropOrdinalRangeMin, Butterfly::x_namedPropOrdinalRangeMax);
+                TValue res = heapEntity->m_butterfly->GetNamedProperty(c_slot);
+                return std::make_pair(res, c_resKind);
+            });
+        }
+        }   /* switch icKind */
+    });
+}
+
+// The generic (not inline-cached) lookup used by the metatable slow paths, after 'base' has been replaced by its '__index' table.
+// If the result kind is MayHaveMetatable and the result is nil, the caller must check the metatable of 'base' again.
+//
+static std::pair<TValue, TableGetByIdIcResultKind> WARN_UNUSED ALWAYS_INLINE TableGetByIdWithoutInlineCache(HeapPtr<TableObject> tableObj, HeapPtr<HeapString> index)
+{
+    GetByIdICInfo icInfo;
+    TableObject::PrepareGetByIdWithMegamorphicCache(tableObj, UserHeapPointer<HeapString> { index }, icInfo /*out*/);
+    TValue result = TableObject::GetById(tableObj, index, icInfo);
+    return std::make_pair(result, icInfo.m_mayHaveMetatable ? TableGetByIdIcResultKind::MayHaveMetatable : TableGetByIdIcResultKind::NoMetatable);
+}
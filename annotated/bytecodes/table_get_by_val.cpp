@@ -91,7 +91,7 @@ static void NO_RETURN HandleNotInt64IndexSlowPath(TValue /*bc_base*/, TValue /*b
                 assert(base.Is<tTable>());
                 HeapPtr<TableObject> tableObj = base.As<tTable>();
                 GetByIdICInfo icInfo;
-                TableObject::PrepareGetById(tableObj, UserHeapPointer<void> { tvIndex.As<tHeapEntity>() }, icInfo /*out*/);
+                TableObject::PrepareGetByIdWithMegamorphicCache(tableObj, UserHeapPointer<void> { tvIndex.As<tHeapEntity>() }, icInfo /*out*/);
                 TValue result = TableObject::GetById(tableObj, UserHeapPointer<void> { tvIndex.As<tHeapEntity>() }, icInfo);
                 if (likely(!icInfo.m_mayHaveMetatable || !result.Is<tNil>()))
                 {
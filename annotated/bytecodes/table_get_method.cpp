@@ -0,0 +1,156 @@
+#include "api_define_bytecode.h"
+#include "deegen_api.h"
+#include "api_inline_cache.h"
+
+#include "runtime_utils.h"
+#include "table_get_by_id_ic.h"
+
+// TableGetMethod implements the method lookup part of 'obj:method(args)'.
+// It is equivalent to a Mov that copies 'obj' to the first argument slot of the call frame at 'base',
+// followed by a TableGetById that stores 'obj.method' into base[0] (the output), but only needs one dispatch.
+// The property lookup shares its inline cache logic with TableGetById (see table_get_by_id_ic.h).
+//
+// Note that the call itself is still performed by the following Call bytecode, since Lua requires the method
+// to be looked up before the arguments are evaluated.
+//
+// For the same reason, the inline cache here only caches hidden class -> method slot, not the callee's entry point:
+// the arguments may reassign the method between the lookup and the call, so the Call bytecode has to check the callee
+// anyway, and its own call IC already caches the entry point. So 'obj:method(args)' takes two dispatches (this bytecode
+// and the Call) instead of three (Mov, TableGetById and Call), not one.
+//
+
+static void NO_RETURN TableGetMethodMetamethodCallContinuation(TValue* /*base*/, TValue /*object*/, TValue /*tvIndex*/)
+{
+    Return(GetReturnValue(0));
+}
+
+// Forward declaration due to mutual recursion
+//
+static void NO_RETURN HandleMetatableSlowPath(TValue* /*bc_base*/, TValue /*bc_object*/, TValue /*bc_tvIndex*/, TValue base, TValue metamethod);
+
+// At this point, we know that 'rawget(base, index)' is nil and 'base' might have a metatable
+//
+static void NO_RETURN CheckMetatableSlowPath(TValue* /*bc_base*/, TValue /*bc_object*/, TValue /*bc_index*/, TValue base)
+{
+    assert(base.Is<tTable>());
+    TableObject::GetMetatableResult gmr = TableObject::GetMetatable(base.As<tTable>());
+    if (gmr.m_result.m_value != 0)
+    {
+        HeapPtr<TableObject> metatable = gmr.m_result.As<TableObject>();
+        if (unlikely(!TableObject::TryQuicklyRuleOutMetamethod(metatable, LuaMetamethodKind::Index)))
+        {
+            TValue metamethod = GetMetamethodFromMetatable(metatable, LuaMetamethodKind::Index);
+            if (!metamethod.Is<tNil>())
+            {
+                EnterSlowPath<HandleMetatableSlowPath>(base, metamethod);
+            }
+        }
+    }
+    Return(TValue::Create<tNil>());
+}
+
+// At this point, we know that 'base' is not a table
+//
+static void NO_RETURN HandleNotTableObjectSlowPath(TValue* /*bc_base*/, TValue /*bc_object*/, TValue /*bc_tvIndex*/, TValue base)
+{
+    assert(!base.Is<tTable>());
+    TValue metamethod = GetMetamethodForValue(base, LuaMetamethodKind::Index);
+    if (metamethod.Is<tNil>())
+    {
+        ThrowError("bad type for TableGetMethod");
+    }
+    EnterSlowPath<HandleMetatableSlowPath>(base, metamethod);
+}
+
+// At this point, we know that 'rawget(base, index)' is nil, and 'base' has a non-nil metamethod which we shall use
+//
+static void NO_RETURN HandleMetatableSlowPath(TValue* /*bc_base*/, TValue /*bc_object*/, TValue tvIndex, TValue base, TValue metamethod)
+{
+    // If 'metamethod' is a function, we should invoke the metamethod
+    //
+    if (likely(metamethod.Is<tFunction>()))
+    {
+        MakeCall(metamethod.As<tFunction>(), base, tvIndex, TableGetMethodMetamethodCallContinuation);
+    }
+
+    // Otherwise, we should repeat operation on 'metamethod' (i.e., recurse on metamethod[index])
+    //
+    base = metamethod;
+
+    if (unlikely(!base.Is<tTable>()))
+    {
+        EnterSlowPath<HandleNotTableObjectSlowPath>(base);
+    }
+
+    assert(tvIndex.Is<tString>());
+    HeapPtr<HeapString> index = tvIndex.As<tString>();
+
+    auto [result, resultKind] = TableGetByIdWithoutInlineCache(base.As<tTable>(), index);
+    if (unlikely(resultKind == TableGetByIdIcResultKind::MayHaveMetatable && result.Is<tNil>()))
+    {
+        EnterSlowPath<CheckMetatableSlowPath>(base);
+    }
+    Return(result);
+}
+
+static void NO_RETURN TableGetMethodImpl(TValue* bcBase, TValue base, TValue tvIndex)
+{
+    assert(tvIndex.Is<tString>());
+    HeapPtr<HeapString> index = tvIndex.As<tString>();
+
+    // Copy the object to the first argument slot of the call frame.
+    // Note that 'base' has been loaded already, so this is correct even if the object slot is the call base itself.
+    //
+    bcBase[x_numSlotsForStackFrameHeader] = base;
+
+    if (likely(base.Is<tHeapEntity>()))
+    {
+        HeapPtr<TableObject> heapEntity = reinterpret_cast<HeapPtr<TableObject>>(base.As<tHeapEntity>());
+        using ResKind = TableGetByIdIcResultKind;
+        auto [result, resultKind] = TableGetByIdWithInlineCache(heapEntity, index);
+
+        switch (resultKind)
+        {
+        case ResKind::NoMetatable: [[likely]]
+        {
+            Return(result);
+        }
+        case ResKind::NotTable: [[unlikely]]
+        {
+            EnterSlowPath<HandleNotTableObjectSlowPath>(base);
+        }
+        case ResKind::MayHaveMetatable:
+        {
+            if (likely(!result.Is<tNil>()))
+            {
+                Return(result);
+            }
+            EnterSlowPath<CheckMetatableSlowPath>(base);
+        }
+        }   /* switch resultKind*/
+    }
+    else
+    {
+        EnterSlowPath<HandleNotTableObjectSlowPath>(base);
+    }
+}
+
+DEEGEN_DEFINE_BYTECODE(TableGetMethod)
+{
+    Operands(
+        BytecodeRangeBaseRW("base"),
+        BytecodeSlot("object"),
+        Constant("index")
+    );
+    Result(BytecodeValue);
+    Implementation(TableGetMethodImpl);
+    Variant(
+        Op("index").IsConstant<tString>()
+    );
+    DeclareReads();
+    DeclareWrites(
+        Range(Op("base") + x_numSlotsForStackFrameHeader, 1)
+    );
+}
+
+DEEGEN_END_BYTECODE_DEFINITIONS
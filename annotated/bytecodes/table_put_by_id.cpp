@@ -31,7 +31,7 @@ static void NO_RETURN HandleMetamethodSlowPath(TValue base, TValue tvIndex, TVal
             {
                 HeapPtr<TableObject> tableObj = metamethod.As<tTable>();
                 PutByIdICInfo icInfo;
-                TableObject::PreparePutById(tableObj, UserHeapPointer<HeapString> { index }, icInfo /*out*/);
+                TableObject::PreparePutByIdWithMegamorphicCache(tableObj, UserHeapPointer<HeapString> { index }, icInfo /*out*/);
 
                 if (unlikely(TableObject::PutByIdNeedToCheckMetatable(tableObj, icInfo)))
                 {
@@ -130,7 +130,7 @@ static void NO_RETURN TablePutByIdImpl(TValue base, TValue tvIndex, TValue value
             }
 
             PutByIdICInfo c_info;
-            TableObject::PreparePutById(tableObj, UserHeapPointer<HeapString> { index } , c_info /*out*/);
+            TableObject::PreparePutByIdWithMegamorphicCache(tableObj, UserHeapPointer<HeapString> { index }, c_info /*out*/);
 
             int32_t c_slot = c_info.m_slot;
             PutByIdICInfo::ICKind c_icKind = c_info.m_icKind;
@@ -226,7 +226,7 @@ double_index_handle_metamethod:
             HeapPtr<TableObject> tableObj = base.As<tTable>();
 
             PutByIdICInfo icInfo;
-            TableObject::PreparePutById(tableObj, key, icInfo /*out*/);
+            TableObject::PreparePutByIdWithMegamorphicCache(tableObj, key, icInfo /*out*/);
 
             TValue metamethod;
             if (unlikely(TableObject::PutByIdNeedToCheckMetatable(tableObj, icInfo)))
@@ -14,20 +14,17 @@ static void NO_RETURN TableVariadicPutBySeqImpl(TValue base, TValue tvIndex)
     HeapPtr<TableObject> tableObj = base.As<tTable>();
 
     // Since this opcode only shows up in a table initializer expression, 'base' must have no metatable.
-    // For now we simply use a naive loop of PutByIntegerVal: this isn't performance sensitive after all, so just stay simple for now
+    // This is on the hot path of varargs packing ('local args = { ... }'), so we use the bulk put, which sizes the vector storage once
+    // and copies all the values in one go when possible.
+    //
+    // We can safely ignore the case where we are putting so many items that it overflows int32_t. As Lua states:
+    //     "Fields of the form 'exp' are equivalent to [i] = exp, where i are consecutive numerical
+    //     integers, starting with 1. Fields in the other formats do not affect this counting."
+    // So in order for this index to overflow, there needs to have 2^31 terms in the table, which is impossible
     //
     TValue* src = VariadicResultsAccessor::GetPtr();
-    int32_t numTermsToPut = static_cast<int32_t>(VariadicResultsAccessor::GetNum());
-    for (int32_t i = 0; i < numTermsToPut; i++)
-    {
-        // We can safely ignore the case where we are putting so many items that it overflows int32_t. As Lua states:
-        //     "Fields of the form 'exp' are equivalent to [i] = exp, where i are consecutive numerical
-        //     integers, starting with 1. Fields in the other formats do not affect this counting."
-        // So in order for this index to overflow, there needs to have 2^31 terms in the table, which is impossible
-        //
-        int32_t idx = indexStart + i;
-        TableObject::RawPutByValIntegerIndex(tableObj, idx, src[i]);
-    }
+    uint32_t numTermsToPut = static_cast<uint32_t>(VariadicResultsAccessor::GetNum());
+    TableObject::RawPutSequenceByIntegerIndex(tableObj, indexStart, src, numTermsToPut);
     Return();
 }
 
@@ -0,0 +1,11 @@
+#include "force_release_build.h"
+
+#include "define_deegen_common_snippet.h"
+#include "runtime_utils.h"
+
+static void DeegenSnippet_MarkBaselineCodeBlockRecentlyUsed(BaselineCodeBlock* bcb)
+{
+    bcb->m_recentlyUsed = 1;
+}
+
+DEFINE_DEEGEN_COMMON_SNIPPET("MarkBaselineCodeBlockRecentlyUsed", DeegenSnippet_MarkBaselineCodeBlockRecentlyUsed)
@@ -0,0 +1,24 @@
+#include "force_release_build.h"
+
+#include "define_deegen_common_snippet.h"
+#include "runtime_utils.h"
+#include "deegen_options.h"
+#include "sampling_profiler.h"
+
+// 'location' is the current bytecode pointer for the interpreter, the current SlowPathData pointer for the baseline JIT,
+// or nullptr at function entry
+//
+// Note that the pending tick counter is read with a relaxed atomic load, since the SIGPROF handler may increment it at any time
+//
+static void DeegenSnippet_SamplingProfilerSafepoint(void* stackBase, uint64_t isBaselineJit, void* location)
+{
+    if (x_enable_sampling_profiler_safepoints)
+    {
+        if (unlikely(VM::GetSamplingProfilerPendingTicksFromInterpreter() != 0))
+        {
+            deegen_sampling_profiler_record_sample(stackBase, isBaselineJit, location);
+        }
+    }
+}
+
+DEFINE_DEEGEN_COMMON_SNIPPET("SamplingProfilerSafepoint", DeegenSnippet_SamplingProfilerSafepoint)
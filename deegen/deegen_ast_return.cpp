@@ -113,6 +113,11 @@ void AstBytecodeReturn::DoLoweringForInterpreter(InterpreterBytecodeImplCreator*
         bytecodeTarget = GetElementPtrInst::CreateInBounds(llvm_type_of<uint8_t>(ctx), ifi->GetCurBytecode(), { offset64 }, "", m_origin /*insertBefore*/);
 
         ifi->CallDeegenCommonSnippet("UpdateInterpreterTierUpCounterForBranch", { ifi->GetInterpreterCodeBlock(), ifi->GetCurBytecode(), bytecodeTarget }, m_origin /*insertBefore*/);
+
+        if (x_enable_sampling_profiler_safepoints)
+        {
+            ifi->CallDeegenCommonSnippet("SamplingProfilerSafepoint", { ifi->GetStackBase(), CreateLLVMConstantInt<uint64_t>(ctx, 0), ifi->GetCurBytecode() }, m_origin /*insertBefore*/);
+        }
     }
     else
     {
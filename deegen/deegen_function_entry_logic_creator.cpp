@@ -249,6 +249,21 @@ void DeegenFunctionEntryLogicCreator::Run(llvm::LLVMContext& ctx)
     ReleaseAssert(llvm_value_has_type<void*>(calleeCodeBlock));
     calleeCodeBlock->setName("calleeCodeBlock");
 
+    // Check for a pending sampling profiler tick. The stack frame header of the callee has been populated by the caller,
+    // so the stack is walkable here, even before the stack frame is fixed up for the variadic arguments
+    //
+    if (x_enable_sampling_profiler_safepoints)
+    {
+        CreateCallToDeegenCommonSnippet(module.get(),
+                                        "SamplingProfilerSafepoint",
+                                        {
+                                            preFixupStackBase,
+                                            CreateLLVMConstantInt<uint64_t>(ctx, m_tier == DeegenEngineTier::BaselineJIT ? 1 : 0),
+                                            ConstantPointerNull::get(PointerType::get(ctx, 0 /*addressSpace*/))
+                                        },
+                                        normalBB);
+    }
+
     Value* bytecodePtr = nullptr;
     if (m_tier == DeegenEngineTier::Interpreter)
     {
@@ -351,6 +366,10 @@ void DeegenFunctionEntryLogicCreator::Run(llvm::LLVMContext& ctx)
 
         Value* baselineCodeBlock = CreateCallToDeegenCommonSnippet(module.get(), "GetBaselineJitCodeBlockFromCodeBlockHeapPtr", { calleeCodeBlockHeapPtr }, dummyInst);
 
+        // Tell the code cache eviction logic that this function is in use
+        //
+        CreateCallToDeegenCommonSnippet(module.get(), "MarkBaselineCodeBlockRecentlyUsed", { baselineCodeBlock }, dummyInst);
+
         InterpreterFunctionInterface::CreateDispatchToBytecode(
             target,
             coroutineCtx,
@@ -15,6 +15,7 @@
 #include "deegen_stencil_lowering_pass.h"
 #include "invoke_clang_helper.h"
 #include "llvm_override_option.h"
+#include "deegen_options.h"
 #include "llvm/Linker/Linker.h"
 
 namespace dast {
@@ -308,6 +309,29 @@ void JitImplCreatorBase::CreateWrapperFunction()
         }
     }
 
+    // For baseline JIT, the loop back-edges and loop headers (i.e., the bytecodes where the interpreter checks for OSR entry into baseline JIT)
+    // are the safepoints for the sampling profiler inside a function
+    //
+    if (IsBaselineJIT() && IsMainComponent() && m_bytecodeDef->m_isInterpreterToBaselineJitOsrEntryPoint && x_enable_sampling_profiler_safepoints)
+    {
+        ReleaseAssert(!IsJitSlowPath());
+        Value* slowPathDataOffset = GetSlowPathDataOffsetFromJitFastPath(currentBlock);
+        Value* slowPathData = GetElementPtrInst::CreateInBounds(llvm_type_of<uint8_t>(ctx), GetJitCodeBlock(), { slowPathDataOffset }, "", currentBlock);
+        CreateCallToDeegenCommonSnippet(GetModule(),
+                                        "SamplingProfilerSafepoint",
+                                        { GetStackBase(), CreateLLVMConstantInt<uint64_t>(ctx, 1), slowPathData },
+                                        currentBlock);
+    }
+
+    // A long-running loop may not go through the function entry for a long time, so the loop headers also tell the code cache
+    // eviction logic that this function is in use
+    //
+    if (IsBaselineJIT() && IsMainComponent() && m_bytecodeDef->m_isInterpreterToBaselineJitOsrEntryPoint)
+    {
+        ReleaseAssert(!IsJitSlowPath());
+        CreateCallToDeegenCommonSnippet(GetModule(), "MarkBaselineCodeBlockRecentlyUsed", { GetJitCodeBlock() }, currentBlock);
+    }
+
     std::unordered_map<uint64_t /*operandOrd*/, uint64_t /*argOrd*/> alreadyDecodedArgs;
     if (m_processKind == BytecodeIrComponentKind::QuickeningSlowPath && m_bytecodeDef->HasQuickeningSlowPath())
     {
@@ -40,9 +40,53 @@ constexpr bool x_allow_baseline_jit_tier_up_to_optimizing_jit = true;
 //
 constexpr size_t x_interpreter_tier_up_threshold_bytecode_length_multiplier = 20;
 
+// The multipliers above can be changed per VM at runtime by VM::SetInterpreterTierUpPolicy.
+//
+// The 'aggressive' policy is meant for long-running programs (e.g., servers), where the one-time JIT cost is negligible
+// compared with the total running time, so we may JIT even if most of the functions turn out to be not that hot.
+// The 'conservative' policy is meant for short-running scripts, where many functions run only a few times before the
+// script exits, so JIT'ing them is often a waste.
+//
+constexpr size_t x_interpreter_tier_up_aggressive_threshold_bytecode_length_multiplier = 5;
+constexpr size_t x_interpreter_tier_up_conservative_threshold_bytecode_length_multiplier = 80;
+
+// The 'adaptive' policy recomputes the multiplier from the measured baseline JIT compilation speed, using the
+// same rent-to-buy reasoning as above: multiplier = C * (time to JIT one bytecode) / (time to interpret one bytecode).
+// Note that only the JIT compile time is adaptive. The time to interpret one bytecode is never measured (it would require
+// timing every dispatch), and is the fixed estimate below, from the geomean interpreter throughput above (377M bytecode/s),
+// so the policy does not react to programs whose bytecodes are unusually cheap or expensive to interpret.
+// The result is clamped to the range [aggressive multiplier, conservative multiplier].
+// The multiplier for a newly-created function is computed from the aggregated speed of all compilations so far.
+// A function whose JIT code has been evicted from the JIT code cache (see VM::SetJitCodeCacheSizeLimit) has been compiled before,
+// so its new threshold is instead computed from its own measured compilation speed.
+//
+constexpr double x_interpreter_estimated_nanoseconds_per_bytecode = 2.65;
+
 // Do not tier up to DFG if a function contains more than this many bytecodes.
 //
 constexpr size_t x_forbid_tier_up_to_dfg_num_bytecodes_threshold = 200000;
 
+// When this option is true, the hot JIT code (the baseline JIT fast paths and the IC stubs) is allocated from memory backed by
+// 2MB transparent huge pages (if the kernel supports it), to reduce iTLB misses for programs with a lot of JIT code.
+// The baseline JIT slow paths are always allocated separately from the fast paths, so they do not dilute the hot pages.
+//
+constexpr bool x_jit_use_transparent_huge_pages_for_hot_code = true;
+
+// When this option is true, the data section of baseline JIT code is made read-only once the codegen has finished writing it.
+// This costs an mprotect call to open the 16KB page for the allocation and another to seal it, for every compilation that
+// has a data section (and again when the code is evicted). On a VM guest the pair measured ~6.5us, which made allocating and
+// sealing a data section ~10us instead of ~0.35us, so turn this off if compilation latency matters more than hardening.
+//
+constexpr bool x_jit_write_protect_data_sections = true;
+
+// When this option is true, the interpreter and the baseline JIT code check for a pending sampling profiler tick at every
+// function entry and every loop back-edge (for the interpreter, every taken branch), and record the guest language stack
+// if there is one (see SamplingProfiler). The check costs a load and a branch when the profiler is not running.
+//
+// This is off by default so that the check is not on the hot path of every function call and loop iteration.
+// When it is off, the sampling profiler cannot be started.
+//
+constexpr bool x_enable_sampling_profiler_safepoints = false;
+
 static_assert(!(!x_allow_interpreter_tier_up_to_baseline_jit && x_allow_baseline_jit_tier_up_to_optimizing_jit),
               "Enabling optimizing JIT requires enabling baseline JIT as well!");
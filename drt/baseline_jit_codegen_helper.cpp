@@ -2,6 +2,7 @@
 #include "runtime_utils.h"
 #include "bytecode_builder.h"
 #include "temp_arena_allocator.h"
+#include "deegen_options.h"
 
 // These tables are generated by Deegen
 //
@@ -60,6 +61,9 @@ BaselineCodeBlock* NO_INLINE deegen_baseline_jit_do_codegen(CodeBlock* cb)
     //
     ReleaseAssert(cb->m_baselineCodeBlock == nullptr);
 
+    struct timespec compileStartTime;
+    AutoTimer::gettime(&compileStartTime);
+
     uint8_t* bytecodeStream = cb->GetBytecodeStream();
     uint8_t* bytecodeStreamEnd = bytecodeStream + cb->GetBytecodeLength();
 
@@ -101,50 +105,54 @@ BaselineCodeBlock* NO_INLINE deegen_baseline_jit_do_codegen(CodeBlock* cb)
     }
 
     // Determine the layout of the generated code:
-    //     [ Data Section ] [ Fast Path ] [ Slow Path ]
+    //     [ Fast Path ]          in the hot JIT memory region
+    //     [ Slow Path ]          in the cold JIT memory region
+    //     [ Data Section ]       in the (non-executable) JIT data memory region
+    // so that the fast paths of different functions are packed together instead of being interleaved with rarely executed slow paths
+    // and constant data. This works because all JIT code and data reside in the first 2GB address space, so the sections can reach
+    // each other with 32-bit offsets.
+    //
     // Note that however, the codegen may overwrite at most 7 more bytes after each section, so allocation must account for that.
     //
+    // 'x_maxBytesCodegenFnMayOverwrite' bytes of NOP needs to be populated after the fast path code and
+    // the slow path code sections to avoid breaking debugger disassembler
+    //
     constexpr size_t x_maxBytesCodegenFnMayOverwrite = 7;
-    size_t fastPathSectionOffset = dataSectionCodeLen;
+    size_t totalJitRegionSize = fastPathCodeLen + x_maxBytesCodegenFnMayOverwrite;
+    size_t totalJitSlowPathRegionSize = slowPathCodeLen + x_maxBytesCodegenFnMayOverwrite;
+    size_t totalJitDataSecRegionSize = 0;
     if (dataSectionCodeLen > 0)
     {
-        // Only add the padding if the data section is not empty (it is often empty),
-        // since if the data section is empty, the codegen won't write anything at all so the padding is not needed.
-        // This way we don't waste 16 bytes if the data section is empty.
+        // Only allocate the data section if it is not empty (it is often empty),
+        // since if the data section is empty, the codegen won't write anything at all
         //
-        fastPathSectionOffset += x_maxBytesCodegenFnMayOverwrite;
+        totalJitDataSecRegionSize = dataSectionCodeLen + x_maxBytesCodegenFnMayOverwrite;
     }
-    // Make the function entry address 16-byte aligned
-    //
-    fastPathSectionOffset = RoundUpToMultipleOf<16>(fastPathSectionOffset);
-
-    // 'x_maxBytesCodegenFnMayOverwrite' bytes of NOP needs to be populated between the fast path code and
-    // the slow path code sections to avoid breaking debugger disassembler
-    //
-    size_t fastPathSectionEnd = fastPathSectionOffset + fastPathCodeLen;
 
-    size_t slowPathSectionOffset = fastPathSectionEnd + x_maxBytesCodegenFnMayOverwrite;
-    size_t slowPathSectionEnd = slowPathSectionOffset + slowPathCodeLen;
-
-    size_t totalJitRegionSize = slowPathSectionEnd + x_maxBytesCodegenFnMayOverwrite;
-
-    // TODO: right now the data section is also marked executable because we just use one mmap for simplicity..
-    //
     VM* vm = VM::GetActiveVMForCurrentThread();
     vm->IncrementNumTotalBaselineJitCompilations();
-    JitMemoryAllocator* jitAlloc = vm->GetJITMemoryAlloc();
-    void* regionVoidPtr = jitAlloc->AllocateGivenSize(totalJitRegionSize);
+    void* regionVoidPtr = vm->GetJITMemoryAlloc()->AllocateGivenSize(totalJitRegionSize);
     assert(regionVoidPtr != nullptr);
+    void* slowPathRegionVoidPtr = vm->GetJITColdMemoryAlloc()->AllocateGivenSize(totalJitSlowPathRegionSize);
+    assert(slowPathRegionVoidPtr != nullptr);
+    void* dataSecRegionVoidPtr = nullptr;
+    if (totalJitDataSecRegionSize > 0)
+    {
+        dataSecRegionVoidPtr = vm->GetJITDataMemoryAlloc()->AllocateGivenSize(totalJitDataSecRegionSize);
+        assert(dataSecRegionVoidPtr != nullptr);
+    }
 
-    uint8_t* dataSecPtr = reinterpret_cast<uint8_t*>(regionVoidPtr);
+    // The allocator always returns 16-byte-aligned memory, which makes the function entry address 16-byte aligned
+    //
+    uint8_t* fastPathSecPtr = reinterpret_cast<uint8_t*>(regionVoidPtr);
+    uint8_t* slowPathSecPtr = reinterpret_cast<uint8_t*>(slowPathRegionVoidPtr);
+    uint8_t* dataSecPtr = reinterpret_cast<uint8_t*>(dataSecRegionVoidPtr);
+    assert(reinterpret_cast<uintptr_t>(fastPathSecPtr) % 16 == 0);
 
     // This is required in order for all the computations above about the data section size to hold
     //
     assert(reinterpret_cast<uintptr_t>(dataSecPtr) % x_baselineJitMaxPossibleDataSectionAlignment == 0);
 
-    uint8_t* fastPathSecPtr = dataSecPtr + fastPathSectionOffset;
-    uint8_t* slowPathSecPtr = dataSecPtr + slowPathSectionOffset;
-
     uint8_t* fastPathSecTrueEnd = fastPathSecPtr + fastPathCodeLen;
     uint8_t* slowPathSecTrueEnd = slowPathSecPtr + slowPathCodeLen;
 
@@ -154,8 +162,12 @@ BaselineCodeBlock* NO_INLINE deegen_baseline_jit_do_codegen(CodeBlock* cb)
                                                        SafeIntegerCast<uint32_t>(numBytecodes),
                                                        SafeIntegerCast<uint32_t>(slowPathDataStreamLen),
                                                        fastPathSecPtr /*jitCodeEntry*/,
-                                                       dataSecPtr /*jitRegionStart*/,
-                                                       SafeIntegerCast<uint32_t>(totalJitRegionSize));
+                                                       fastPathSecPtr /*jitRegionStart*/,
+                                                       SafeIntegerCast<uint32_t>(totalJitRegionSize),
+                                                       slowPathSecPtr /*jitSlowPathRegionStart*/,
+                                                       SafeIntegerCast<uint32_t>(totalJitSlowPathRegionSize),
+                                                       dataSecPtr /*jitDataSecRegionStart*/,
+                                                       SafeIntegerCast<uint32_t>(totalJitDataSecRegionSize));
 
     BaselineCodeBlock::SlowPathDataAndBytecodeOffset* slowPathDataIndexArray = bcb->m_sbIndex;
     uint8_t* slowPathDataStreamStart = bcb->GetSlowPathDataStreamStart();
@@ -274,11 +286,11 @@ BaselineCodeBlock* NO_INLINE deegen_baseline_jit_do_codegen(CodeBlock* cb)
         }
     }
 
-    // There is a 'x_maxBytesCodegenFnMayOverwrite' byte gap between fast path and slow path
+    // There is a 'x_maxBytesCodegenFnMayOverwrite' byte gap after the fast path
     // Populate ud2 + N * nop for sanity and to avoid breaking debugger disassembler.
     //
-    // And also do the same at the end of slow path, so that the full [jitCodeEntry, jitRegionEnd) recorded
-    // in BaselineCodeBlock is filled with disassemblable instructions
+    // And also do the same at the end of slow path, so that the full [jitCodeEntry, jitRegionEnd) and the full slow path region
+    // recorded in BaselineCodeBlock are filled with disassemblable instructions
     //
     {
         auto populateCodeGap = [](uint8_t* buf) ALWAYS_INLINE
@@ -300,11 +312,43 @@ BaselineCodeBlock* NO_INLINE deegen_baseline_jit_do_codegen(CodeBlock* cb)
         populateCodeGap(slowPathSecTrueEnd);
     }
 
+    // The data section is never written after codegen (including the late patches above), so make it read-only
+    //
+    if (x_jit_write_protect_data_sections && dataSecPtr != nullptr)
+    {
+        vm->GetJITDataMemoryAlloc()->WriteProtect(dataSecPtr);
+    }
+
+    if (vm->GetPerfJitCodeMap() != nullptr)
+    {
+        std::string name = "lua:" + cb->m_owner->GetDebugName() + " [baseline]";
+        vm->GetPerfJitCodeMap()->RecordCode(fastPathSecPtr, fastPathCodeLen, name.c_str());
+        name = "lua:" + cb->m_owner->GetDebugName() + " [baseline slow path]";
+        vm->GetPerfJitCodeMap()->RecordCode(slowPathSecPtr, slowPathCodeLen, name.c_str());
+    }
+
     // Update best entry point from interpreter code to baseline JIT code
     //
     assert(cb->m_bestEntryPoint == cb->m_owner->GetInterpreterEntryPoint());
     cb->UpdateBestEntryPoint(bcb->m_jitCodeEntry);
     assert(cb->m_bestEntryPoint == bcb->m_jitCodeEntry);
+
+    vm->GetLiveBaselineCodeBlocks().push_back(bcb);
+
+    if (vm->IsBaselineJitWarmupCacheEnabled())
+    {
+        vm->RecordBaselineJitWarmupCacheKey(cb->m_owner->ComputeBaselineJitWarmupCacheKey());
+    }
+
+    // Record the compilation speed, which the adaptive interpreter tier-up policy uses to decide the tier-up threshold
+    //
+    {
+        struct timespec compileEndTime;
+        AutoTimer::gettime(&compileEndTime);
+        double secondsElapsed = AutoTimer::tdiff(&compileStartTime, &compileEndTime);
+        bcb->m_compilationTimeNs = static_cast<uint64_t>(secondsElapsed * 1e9);
+        vm->RecordBaselineJitCompilationTime(numBytecodes, bcb->m_compilationTimeNs);
+    }
     return bcb;
 }
 
@@ -319,9 +363,20 @@ JitGenericInlineCacheEntry* WARN_UNUSED JitGenericInlineCacheEntry::Create(VM* v
     uint8_t allocationStepping = deegen_baseline_jit_generic_ic_jit_allocation_stepping_table[icTraitKind];
     entry->m_jitRegionLengthStepping = allocationStepping;
     entry->m_jitAddr = vm->GetJITMemoryAlloc()->AllocateGivenStepping(allocationStepping);
+    if (vm->GetPerfJitCodeMap() != nullptr)
+    {
+        std::string name = "lua:generic IC stub #" + std::to_string(icTraitKind);
+        vm->GetPerfJitCodeMap()->RecordCodeWithoutCodeBytes(entry->m_jitAddr, x_jit_mem_alloc_stepping_array[allocationStepping], name.c_str());
+    }
     return entry;
 }
 
+void JitGenericInlineCacheEntry::Destroy(VM* vm)
+{
+    vm->GetJITMemoryAlloc()->Free(m_jitAddr);
+    vm->DeallocateSpdsRegionObject(this);
+}
+
 void* WARN_UNUSED JitGenericInlineCacheSite::Insert(uint16_t traitKind)
 {
     assert(m_numEntries < x_maxJitGenericInlineCacheEntries);
@@ -332,9 +387,249 @@ void* WARN_UNUSED JitGenericInlineCacheSite::Insert(uint16_t traitKind)
     return entry->m_jitAddr;
 }
 
+// Invoke 'callIcFn(JitCallInlineCacheSite*)' and 'genericIcFn(JitGenericInlineCacheSite*)' on every IC site in the baseline JIT code
+//
+template<typename CallIcFn, typename GenericIcFn>
+static void ForEachIcSiteInBaselineCodeBlock(BaselineCodeBlock* bcb, const CallIcFn& callIcFn, const GenericIcFn& genericIcFn)
+{
+    for (size_t bytecodeIndex = 0; bytecodeIndex < bcb->m_numBytecodes; bytecodeIndex++)
+    {
+        uint8_t* slowPathDataStruct = bcb->GetSlowPathDataAtBytecodeIndex(bytecodeIndex);
+        BytecodeOpcodeTy opcode = UnalignedLoad<BytecodeOpcodeTy>(slowPathDataStruct);
+        assert(opcode < DeegenBytecodeBuilder::BytecodeBuilder::GetTotalBytecodeKinds());
+        const BytecodeBaselineJitTraits& trait = deegen_baseline_jit_bytecode_trait_table[opcode];
+        for (size_t i = 0; i < trait.m_numCallIcSites; i++)
+        {
+            callIcFn(reinterpret_cast<JitCallInlineCacheSite*>(slowPathDataStruct + trait.m_callIcSiteOffsetInSlowPathData) + i);
+        }
+        for (size_t i = 0; i < trait.m_numGenericIcSites; i++)
+        {
+            genericIcFn(reinterpret_cast<JitGenericInlineCacheSite*>(slowPathDataStruct + trait.m_genericIcSiteOffsetInSlowPathData) + i);
+        }
+    }
+}
+
+// Throw away the baseline JIT code of 'bcb' (including all the IC stubs it owns), so the function runs in the interpreter again
+// and may tier up again later.
+//
+// The caller is responsible for making sure that no stack frame is executing the JIT code or will return into it.
+// The BaselineCodeBlock itself lives in the system heap, which cannot free memory, so it is handed to the VM and
+// reused when the function is compiled again.
+//
+// Note that there is no CodeJettisonWatchpoint to remove here: baseline JIT code never speculates, so it never registers
+// any watchpoint. The watchpoint kind is reserved for the optimizing JIT, whose code must be jettisoned when a watched
+// assumption breaks.
+//
+static void JettisonBaselineCodeBlock(VM* vm, BaselineCodeBlock* bcb)
+{
+    CodeBlock* cb = bcb->m_owner;
+    assert(cb->m_baselineCodeBlock == bcb);
+    assert(cb->m_dfgCodeBlock == nullptr);
+    assert(cb->m_bestEntryPoint == bcb->m_jitCodeEntry);
+
+    // This also redirects all the call ICs (in the interpreter and in other JIT code) that cache on this function to the interpreter
+    //
+    cb->UpdateBestEntryPoint(cb->m_owner->GetInterpreterEntryPoint());
+    cb->m_baselineCodeBlock = nullptr;
+    if (vm->InterpreterCanTierUpFurther())
+    {
+        size_t multiplier = vm->GetInterpreterTierUpThresholdMultiplierForRecompilation(bcb->m_numBytecodes, bcb->m_compilationTimeNs);
+        cb->m_interpreterTierUpCounter = static_cast<int64_t>(multiplier * cb->m_bytecodeLengthIncludingTailPadding);
+    }
+    else
+    {
+        cb->m_interpreterTierUpCounter = 1LL << 62;
+    }
+
+    // Destroy all the IC entries owned by the JIT code. For call ICs, this also removes them from the callee's IC list.
+    //
+    ForEachIcSiteInBaselineCodeBlock(
+        bcb,
+        [&](JitCallInlineCacheSite* site) ALWAYS_INLINE
+        {
+            SpdsPtr<JitCallInlineCacheEntry> node = TCGet(site->m_linkedListHead);
+            while (!node.IsInvalidPtr())
+            {
+                JitCallInlineCacheEntry* entry = TranslateToRawPointer(vm, node.AsPtr());
+                node = TCGet(entry->m_callSiteNextNode);
+                entry->Destroy(vm);
+            }
+            ConstructInPlace(site);
+        },
+        [&](JitGenericInlineCacheSite* site) ALWAYS_INLINE
+        {
+            SpdsPtr<JitGenericInlineCacheEntry> node = TCGet(site->m_linkedListHead);
+            while (!node.IsInvalidPtr())
+            {
+                JitGenericInlineCacheEntry* entry = TranslateToRawPointer(vm, node.AsPtr());
+                node = entry->m_nextNode;
+                entry->Destroy(vm);
+            }
+            ConstructInPlace(site);
+        });
+
+    vm->GetJITMemoryAlloc()->Free(bcb->m_jitRegionStart);
+    bcb->m_jitRegionStart = nullptr;
+    vm->GetJITColdMemoryAlloc()->Free(bcb->m_jitSlowPathRegionStart);
+    bcb->m_jitSlowPathRegionStart = nullptr;
+    if (bcb->m_jitDataSecRegionStart != nullptr)
+    {
+        vm->GetJITDataMemoryAlloc()->Free(bcb->m_jitDataSecRegionStart);
+        bcb->m_jitDataSecRegionStart = nullptr;
+    }
+    vm->RecordJettisonedBaselineCodeBlock(cb, bcb);
+    vm->IncrementNumTotalBaselineJitJettisons();
+}
+
+void EvictBaselineJitCodeIfCodeCacheFull(VM* vm)
+{
+    size_t limit = vm->GetJitCodeCacheSizeLimit();
+    if (likely(limit == 0 || vm->GetTotalJITCodeSize() <= limit))
+    {
+        return;
+    }
+
+    std::vector<BaselineCodeBlock*>& liveBcbList = vm->GetLiveBaselineCodeBlocks();
+    size_t numLive = liveBcbList.size();
+
+    TempArenaAllocator alloc;
+
+    // Compute the JIT memory owned by each function (main JIT region plus all the IC stubs),
+    // and the address ranges that a live stack frame may be executing or may return into
+    //
+    struct JitCodeRange
+    {
+        uintptr_t m_start;
+        uintptr_t m_end;
+        size_t m_owner;
+    };
+    TempVector<JitCodeRange> ranges(alloc);
+    TempVector<size_t> ownedJitMemory(alloc);
+    ownedJitMemory.resize(numLive, 0);
+    for (size_t idx = 0; idx < numLive; idx++)
+    {
+        BaselineCodeBlock* bcb = liveBcbList[idx];
+        auto addRange = [&](void* start, size_t len) ALWAYS_INLINE
+        {
+            uintptr_t startAddr = reinterpret_cast<uintptr_t>(start);
+            ranges.push_back({ .m_start = startAddr, .m_end = startAddr + len, .m_owner = idx });
+            ownedJitMemory[idx] += len;
+        };
+        addRange(bcb->m_jitRegionStart, bcb->m_jitRegionSize);
+        addRange(bcb->m_jitSlowPathRegionStart, bcb->m_jitSlowPathRegionSize);
+        // The data section never contains code, so we only need to account for its memory
+        //
+        ownedJitMemory[idx] += bcb->m_jitDataSecRegionSize;
+        ForEachIcSiteInBaselineCodeBlock(
+            bcb,
+            [&](JitCallInlineCacheSite* site) ALWAYS_INLINE
+            {
+                SpdsPtr<JitCallInlineCacheEntry> node = TCGet(site->m_linkedListHead);
+                while (!node.IsInvalidPtr())
+                {
+                    JitCallInlineCacheEntry* entry = TranslateToRawPointer(vm, node.AsPtr());
+                    addRange(entry->GetJitRegionStart(), x_jit_mem_alloc_stepping_array[entry->GetIcTrait()->m_jitCodeAllocationLengthStepping]);
+                    node = TCGet(entry->m_callSiteNextNode);
+                }
+            },
+            [&](JitGenericInlineCacheSite* site) ALWAYS_INLINE
+            {
+                SpdsPtr<JitGenericInlineCacheEntry> node = TCGet(site->m_linkedListHead);
+                while (!node.IsInvalidPtr())
+                {
+                    JitGenericInlineCacheEntry* entry = TranslateToRawPointer(vm, node.AsPtr());
+                    addRange(entry->m_jitAddr, x_jit_mem_alloc_stepping_array[entry->m_jitRegionLengthStepping]);
+                    node = entry->m_nextNode;
+                }
+            });
+    }
+    std::sort(ranges.begin(), ranges.end(), [](const JitCodeRange& lhs, const JitCodeRange& rhs) { return lhs.m_start < rhs.m_start; });
+
+    // Find out the functions that may have a stack frame executing their JIT code.
+    //
+    // There is no stack map, so we conservatively treat every word on the stack of every non-dead coroutine that
+    // points into a function's JIT code as a return address (this includes the stale values above the stack top).
+    // Note that the native stack never contains JIT return addresses, since guest language calls never recurse on the native stack.
+    //
+    TempVector<bool> isPinned(alloc);
+    isPinned.resize(numLive, false);
+    {
+        std::vector<CoroutineRuntimeContext*>& coroList = vm->GetAllCoroutines();
+        size_t numAliveCoros = 0;
+        for (CoroutineRuntimeContext* coro : coroList)
+        {
+            if (coro->m_coroutineStatus.IsDead())
+            {
+                continue;
+            }
+            coroList[numAliveCoros] = coro;
+            numAliveCoros++;
+            for (TValue* slot = coro->m_stackBegin; slot < coro->m_stackEnd; slot++)
+            {
+                uintptr_t value = slot->m_value;
+                auto it = std::upper_bound(ranges.begin(), ranges.end(), value,
+                                           [](uintptr_t val, const JitCodeRange& range) { return val < range.m_start; });
+                if (it == ranges.begin())
+                {
+                    continue;
+                }
+                --it;
+                if (value < it->m_end)
+                {
+                    isPinned[it->m_owner] = true;
+                }
+            }
+        }
+        coroList.resize(numAliveCoros);
+    }
+
+    // Decide which functions to evict, skipping the functions that may still have a live stack frame.
+    //
+    // This is a CLOCK-style approximation of LRU: the JIT code sets BaselineCodeBlock::m_recentlyUsed at function entry
+    // and at loop headers, so we first evict the functions that have not run since the last eviction (oldest compilation first),
+    // and only evict the recently used ones if that is not enough. All the bits are cleared afterwards.
+    //
+    // We evict until the total JIT code size is at 3/4 of the limit, so we don't need to evict again on the next compilation.
+    //
+    size_t curSize = vm->GetTotalJITCodeSize();
+    size_t targetSize = limit / 4 * 3;
+    TempVector<bool> shouldEvict(alloc);
+    shouldEvict.resize(numLive, false);
+    for (bool evictRecentlyUsed : { false, true })
+    {
+        for (size_t idx = 0; idx < numLive && curSize > targetSize; idx++)
+        {
+            if (isPinned[idx] || shouldEvict[idx] || (liveBcbList[idx]->m_recentlyUsed != 0 && !evictRecentlyUsed))
+            {
+                continue;
+            }
+            shouldEvict[idx] = true;
+            curSize -= std::min(curSize, ownedJitMemory[idx]);
+        }
+    }
+
+    size_t numRemaining = 0;
+    for (size_t idx = 0; idx < numLive; idx++)
+    {
+        BaselineCodeBlock* bcb = liveBcbList[idx];
+        if (shouldEvict[idx])
+        {
+            JettisonBaselineCodeBlock(vm, bcb);
+        }
+        else
+        {
+            bcb->m_recentlyUsed = 0;
+            liveBcbList[numRemaining] = bcb;
+            numRemaining++;
+        }
+    }
+    liveBcbList.resize(numRemaining);
+}
+
 BaselineCodeBlockAndEntryPoint NO_INLINE WARN_UNUSED deegen_prepare_tier_up_into_baseline_jit(HeapPtr<CodeBlock> cbHeapPtr)
 {
     CodeBlock* cb = TranslateToRawPointer(cbHeapPtr);
+    EvictBaselineJitCodeIfCodeCacheFull(VM::GetActiveVMForCurrentThread());
     BaselineCodeBlock* bcb = deegen_baseline_jit_do_codegen(cb);
     return {
         .baselineCodeBlock = bcb,
@@ -357,6 +652,7 @@ BaselineCodeBlockAndEntryPoint NO_INLINE WARN_UNUSED deegen_prepare_osr_entry_in
     }
     else
     {
+        EvictBaselineJitCodeIfCodeCacheFull(VM::GetActiveVMForCurrentThread());
         bcb = deegen_baseline_jit_do_codegen(cb);
     }
 
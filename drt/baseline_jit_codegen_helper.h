@@ -7,7 +7,7 @@
 
 // This struct name and member names are hardcoded as they are used by generated C++ code!
 //
-struct BytecodeBaselineJitTraits
+struct alignas(32) BytecodeBaselineJitTraits
 {
     uint16_t m_fastPathCodeLen;
     uint16_t m_slowPathCodeLen;
@@ -18,11 +18,12 @@ struct BytecodeBaselineJitTraits
     uint8_t m_numCondBrLatePatches;
     uint8_t m_numCallIcSites;
     uint16_t m_callIcSiteOffsetInSlowPathData;
-    uint16_t m_unused;
+    uint8_t m_numGenericIcSites;
+    uint16_t m_genericIcSiteOffsetInSlowPathData;
 };
 // Make sure the size of this struct is a power of 2 to make addressing cheap
 //
-static_assert(sizeof(BytecodeBaselineJitTraits) == 16);
+static_assert(sizeof(BytecodeBaselineJitTraits) == 32);
 
 // The max possible m_dataSectionAlignment
 // We assert this at build time, so we know this must be true at runtime
@@ -212,6 +213,12 @@ public:
                                                           SpdsPtr<JitGenericInlineCacheEntry> nextNode,
                                                           uint16_t icTraitKind);
 
+    // Free the JIT code and the entry itself.
+    // Similar to JitCallInlineCacheEntry::Destroy, this doesn't do anything about the singly-linked list anchored at the IC site,
+    // so the only valid use case is when the IC site destroys all the entries it owns.
+    //
+    void Destroy(VM* vm);
+
     // The singly-linked list anchored at the callsite, 0 if last node
     //
     SpdsPtr<JitGenericInlineCacheEntry> m_nextNode;
@@ -268,6 +275,11 @@ struct BaselineCodeBlockAndEntryPoint
     void* entryPoint;
 };
 
+// Throw away the baseline JIT code of the functions that have not run recently until the total JIT code size is
+// well below the limit set by VM::SetJitCodeCacheSizeLimit. No-op if there is no limit or the limit is not exceeded.
+//
+void EvictBaselineJitCodeIfCodeCacheFull(VM* vm);
+
 // Tier-up from interpreter to baseline JIT at a function entry
 //
 extern "C" BaselineCodeBlockAndEntryPoint NO_INLINE WARN_UNUSED deegen_prepare_tier_up_into_baseline_jit(HeapPtr<CodeBlock> cbHeapPtr);
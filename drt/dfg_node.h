@@ -962,7 +962,7 @@ private:
         Flags_HasDirectOutput::Set(m_flags, hasDirectOutput);
         m_numExtraOutputs = SafeIntegerCast<uint16_t>(numExtraOutputs);
 
-        size_t numTotalOutputs = numExtraOutputs + (hasDirectOutput ? 0 : 1);
+        size_t numTotalOutputs = numExtraOutputs + (hasDirectOutput ? 1 : 0);
         if (numTotalOutputs > 0)
         {
             OutputInfo* outputInfoArray = DfgAlloc()->AllocateArray<OutputInfo>(numTotalOutputs);
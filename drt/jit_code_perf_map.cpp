@@ -0,0 +1,175 @@
+#include "jit_code_perf_map.h"
+#include "misc_math_helper.h"
+
+#include <elf.h>
+#include <sys/syscall.h>
+
+namespace {
+
+// The jitdump format is specified in tools/perf/Documentation/jitdump-specification.txt of the Linux kernel source
+//
+struct JitDumpFileHeader
+{
+    static constexpr uint32_t x_magic = 0x4A695444;     // 'JiTD'
+    static constexpr uint32_t x_version = 1;
+
+    uint32_t m_magic;
+    uint32_t m_version;
+    uint32_t m_totalSize;
+    uint32_t m_elfMach;
+    uint32_t m_pad1;
+    uint32_t m_pid;
+    uint64_t m_timestamp;
+    uint64_t m_flags;
+};
+static_assert(sizeof(JitDumpFileHeader) == 40);
+
+struct JitDumpRecordHeader
+{
+    static constexpr uint32_t x_jitCodeLoad = 0;
+
+    uint32_t m_id;
+    uint32_t m_totalSize;
+    uint64_t m_timestamp;
+};
+static_assert(sizeof(JitDumpRecordHeader) == 16);
+
+// Followed by the null-terminated function name and the code bytes
+//
+struct JitDumpCodeLoadRecord
+{
+    JitDumpRecordHeader m_header;
+    uint32_t m_pid;
+    uint32_t m_tid;
+    uint64_t m_vma;
+    uint64_t m_codeAddr;
+    uint64_t m_codeSize;
+    uint64_t m_codeIndex;
+};
+static_assert(sizeof(JitDumpCodeLoadRecord) == 56);
+
+uint64_t WARN_UNUSED GetJitDumpTimestamp()
+{
+    struct timespec ts;
+    int r = clock_gettime(CLOCK_MONOTONIC, &ts);
+    LOG_WARNING_WITH_ERRNO_IF(r != 0, "clock_gettime failed");
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+}   // anonymous namespace
+
+JitCodePerfMapWriter* WARN_UNUSED JitCodePerfMapWriter::Create(bool writeJitDump)
+{
+    JitCodePerfMapWriter* res = new JitCodePerfMapWriter();
+
+    uint32_t pid = static_cast<uint32_t>(getpid());
+    std::string perfMapFileName = "/tmp/perf-" + std::to_string(pid) + ".map";
+    res->m_perfMapFile = fopen(perfMapFileName.c_str(), "w");
+    if (res->m_perfMapFile == nullptr)
+    {
+        LOG_WARNING_WITH_ERRNO("Failed to create perf map file '%s'", perfMapFileName.c_str());
+        delete res;
+        return nullptr;
+    }
+    // The profiler may read the file while the process is still running, so flush every line
+    //
+    setvbuf(res->m_perfMapFile, nullptr, _IOLBF, 0);
+
+    if (writeJitDump)
+    {
+        std::string jitDumpFileName = "/tmp/jit-" + std::to_string(pid) + ".dump";
+        res->m_jitDumpFile = fopen(jitDumpFileName.c_str(), "w+");
+        if (res->m_jitDumpFile == nullptr)
+        {
+            LOG_WARNING_WITH_ERRNO("Failed to create jitdump file '%s'", jitDumpFileName.c_str());
+            delete res;
+            return nullptr;
+        }
+
+        void* marker = mmap(nullptr, static_cast<size_t>(sysconf(_SC_PAGESIZE)), PROT_READ | PROT_EXEC, MAP_PRIVATE, fileno(res->m_jitDumpFile), 0);
+        if (marker == MAP_FAILED)
+        {
+            LOG_WARNING_WITH_ERRNO("Failed to mmap jitdump file '%s'", jitDumpFileName.c_str());
+            delete res;
+            return nullptr;
+        }
+        res->m_jitDumpMarker = marker;
+
+        JitDumpFileHeader header {
+            .m_magic = JitDumpFileHeader::x_magic,
+            .m_version = JitDumpFileHeader::x_version,
+            .m_totalSize = sizeof(JitDumpFileHeader),
+            .m_elfMach = EM_X86_64,
+            .m_pad1 = 0,
+            .m_pid = pid,
+            .m_timestamp = GetJitDumpTimestamp(),
+            .m_flags = 0
+        };
+        if (fwrite(&header, sizeof(header), 1, res->m_jitDumpFile) != 1 || fflush(res->m_jitDumpFile) != 0)
+        {
+            LOG_WARNING_WITH_ERRNO("Failed to write jitdump file '%s'", jitDumpFileName.c_str());
+            delete res;
+            return nullptr;
+        }
+    }
+
+    return res;
+}
+
+JitCodePerfMapWriter::~JitCodePerfMapWriter()
+{
+    if (m_perfMapFile != nullptr)
+    {
+        fclose(m_perfMapFile);
+    }
+    if (m_jitDumpMarker != nullptr)
+    {
+        int r = munmap(m_jitDumpMarker, static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+        LOG_WARNING_WITH_ERRNO_IF(r != 0, "Cannot unmap jitdump marker");
+    }
+    if (m_jitDumpFile != nullptr)
+    {
+        fclose(m_jitDumpFile);
+    }
+}
+
+void JitCodePerfMapWriter::RecordCodeWithoutCodeBytes(const void* codeStart, size_t codeSize, const char* name)
+{
+    fprintf(m_perfMapFile, "%llx %llx %s\n",
+            static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(codeStart)),
+            static_cast<unsigned long long>(codeSize),
+            name);
+}
+
+void JitCodePerfMapWriter::RecordCode(const void* codeStart, size_t codeSize, const char* name)
+{
+    RecordCodeWithoutCodeBytes(codeStart, codeSize, name);
+
+    if (m_jitDumpFile != nullptr)
+    {
+        size_t nameLen = strlen(name) + 1;
+        size_t totalSize = sizeof(JitDumpCodeLoadRecord) + nameLen + codeSize;
+        JitDumpCodeLoadRecord rec {
+            .m_header = {
+                .m_id = JitDumpRecordHeader::x_jitCodeLoad,
+                .m_totalSize = SafeIntegerCast<uint32_t>(totalSize),
+                .m_timestamp = GetJitDumpTimestamp()
+            },
+            .m_pid = static_cast<uint32_t>(getpid()),
+            .m_tid = static_cast<uint32_t>(syscall(SYS_gettid)),
+            .m_vma = reinterpret_cast<uint64_t>(codeStart),
+            .m_codeAddr = reinterpret_cast<uint64_t>(codeStart),
+            .m_codeSize = codeSize,
+            .m_codeIndex = m_jitDumpNextCodeIndex
+        };
+        m_jitDumpNextCodeIndex++;
+
+        bool success = (fwrite(&rec, sizeof(rec), 1, m_jitDumpFile) == 1);
+        success = success && (fwrite(name, 1, nameLen, m_jitDumpFile) == nameLen);
+        success = success && (fwrite(codeStart, 1, codeSize, m_jitDumpFile) == codeSize);
+        // Flush so that the record is complete even if the process is killed while being profiled
+        //
+        success = success && (fflush(m_jitDumpFile) == 0);
+        LOG_WARNING_IF(!success, "Failed to write jitdump record for '%s'", name);
+    }
+}
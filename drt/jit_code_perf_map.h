@@ -0,0 +1,52 @@
+#pragma once
+
+#include "common.h"
+
+// Tells the Linux 'perf' tool about the JIT code, so that samples in JIT code can be attributed to the Lua functions.
+//
+// The code regions are always written to /tmp/perf-<pid>.map, which 'perf report' picks up automatically.
+// Each line is '<start address> <size> <name>', where the address and size are in hex.
+//
+// Optionally, the code regions are also written to /tmp/jit-<pid>.dump in the jitdump format, which records the code bytes
+// as well, so that 'perf inject --jit' can generate an ELF file for each function, and 'perf annotate' can show the JIT code.
+// The jitdump records are timestamped with CLOCK_MONOTONIC, so the profile must be recorded with 'perf record -k 1'.
+//
+// Note that JIT memory is reused after the code is evicted from the code cache, so if eviction happens,
+// a sample may be attributed to a function that has previously occupied the same address.
+//
+class JitCodePerfMapWriter
+{
+public:
+    MAKE_NONCOPYABLE(JitCodePerfMapWriter);
+    MAKE_NONMOVABLE(JitCodePerfMapWriter);
+
+    // Returns nullptr if the files cannot be created
+    //
+    static JitCodePerfMapWriter* WARN_UNUSED Create(bool writeJitDump);
+
+    ~JitCodePerfMapWriter();
+
+    // Record a piece of JIT code whose code bytes have been fully generated
+    //
+    void RecordCode(const void* codeStart, size_t codeSize, const char* name);
+
+    // Record a piece of JIT memory whose code will be generated later (e.g., an IC stub, whose code is generated
+    // after its memory is allocated). Since the code bytes are not available, it is only written to the perf map.
+    //
+    void RecordCodeWithoutCodeBytes(const void* codeStart, size_t codeSize, const char* name);
+
+private:
+    JitCodePerfMapWriter()
+        : m_perfMapFile(nullptr)
+        , m_jitDumpFile(nullptr)
+        , m_jitDumpMarker(nullptr)
+        , m_jitDumpNextCodeIndex(0)
+    { }
+
+    FILE* m_perfMapFile;
+    FILE* m_jitDumpFile;
+    // 'perf record' only learns about the jitdump file if the file is mmap'ed as executable by the process
+    //
+    void* m_jitDumpMarker;
+    uint64_t m_jitDumpNextCodeIndex;
+};
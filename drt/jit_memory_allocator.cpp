@@ -17,10 +17,12 @@ JitMemoryPageHeader* WARN_UNUSED JitMemoryAllocator::AllocateUninitalizedPage()
     constexpr size_t x_pageSize = JitMemoryPageHeaderBase::x_pageSize;
     if (unlikely(m_reservedRangeCur == m_reservedRangeEnd))
     {
-        void* reservedRange = do_mmap_with_custom_alignment(x_pageSize /*alignment*/, x_reserveRangeSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_32BIT);
+        size_t alignment = m_useHugePages ? x_hugePageSize : x_pageSize;
+        void* reservedRange = do_mmap_with_custom_alignment(alignment, x_reserveRangeSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_32BIT);
         m_reservedRangeCur = reinterpret_cast<uint64_t>(reservedRange);
-        assert(m_reservedRangeCur % x_pageSize == 0);
+        assert(m_reservedRangeCur % alignment == 0);
         m_reservedRangeEnd = m_reservedRangeCur + x_reserveRangeSize;
+        m_committedRangeEnd = m_reservedRangeCur;
 
         m_unmapList.push_back(reservedRange);
     }
@@ -30,9 +32,33 @@ JitMemoryPageHeader* WARN_UNUSED JitMemoryAllocator::AllocateUninitalizedPage()
     void* pageAddr = reinterpret_cast<void*>(m_reservedRangeCur);
     m_reservedRangeCur += x_pageSize;
 
-    void* r = mmap(pageAddr, x_pageSize, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE | MAP_FIXED, -1, 0);
-    VM_FAIL_WITH_ERRNO_IF(r == MAP_FAILED, "Failed to allocate JIT memory of size %llu", static_cast<unsigned long long>(x_pageSize));
-    assert(pageAddr == r);
+    if (m_useHugePages)
+    {
+        // Commit the memory one huge page at a time, so that the whole 2MB range is covered by one mapping with MADV_HUGEPAGE,
+        // which allows the kernel to allocate a huge page on the first touch
+        //
+        if (m_committedRangeEnd < m_reservedRangeCur)
+        {
+            assert(m_committedRangeEnd == reinterpret_cast<uint64_t>(pageAddr));
+            assert(m_committedRangeEnd % x_hugePageSize == 0 && m_committedRangeEnd + x_hugePageSize <= m_reservedRangeEnd);
+            void* r = mmap(pageAddr, x_hugePageSize, GetProtFlags(), MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+            VM_FAIL_WITH_ERRNO_IF(r == MAP_FAILED, "Failed to allocate JIT memory of size %llu", static_cast<unsigned long long>(x_hugePageSize));
+            assert(pageAddr == r);
+
+            // This fails if the kernel does not support transparent huge pages, in which case we simply keep using normal pages
+            //
+            std::ignore = madvise(r, x_hugePageSize, MADV_HUGEPAGE);
+
+            m_committedRangeEnd += x_hugePageSize;
+        }
+        assert(m_reservedRangeCur <= m_committedRangeEnd);
+    }
+    else
+    {
+        void* r = mmap(pageAddr, x_pageSize, GetProtFlags(), MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE | MAP_FIXED, -1, 0);
+        VM_FAIL_WITH_ERRNO_IF(r == MAP_FAILED, "Failed to allocate JIT memory of size %llu", static_cast<unsigned long long>(x_pageSize));
+        assert(pageAddr == r);
+    }
 
     m_totalOsMemoryUsage += x_pageSize;
 
@@ -47,11 +73,16 @@ void* WARN_UNUSED JitMemoryAllocator::DoLargeAllocation(size_t size)
 
     void* ptrVoid = do_mmap_with_custom_alignment(x_pageSize /*alignment*/,
                                                   size /*length*/,
-                                                  PROT_READ | PROT_WRITE | PROT_EXEC,
+                                                  GetProtFlags(),
                                                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE | MAP_32BIT);
 
     JitMemoryLargeAllocationHeader* hdr = reinterpret_cast<JitMemoryLargeAllocationHeader*>(ptrVoid);
+    // Linking the new allocation writes the header of the allocation currently at the list head
+    //
+    JitMemoryLargeAllocationHeader::DoublyLink* oldHead = m_laAnchor.next;
+    SetLargeAllocationHeaderProtection(oldHead, true /*writable*/);
     hdr->Initialize(size, &m_laAnchor);
+    SetLargeAllocationHeaderProtection(oldHead, false /*writable*/);
 
     m_totalUsedMemory += size;
     m_totalOsMemoryUsage += size;
@@ -61,6 +92,39 @@ void* WARN_UNUSED JitMemoryAllocator::DoLargeAllocation(size_t size)
     return res;
 }
 
+void JitMemoryAllocator::SetProtection(void* addr, size_t len, bool writable)
+{
+    assert(m_isWriteProtected && !m_isExecutable);
+    assert(reinterpret_cast<uint64_t>(addr) % 4096 == 0 && len % 4096 == 0);
+    int r = mprotect(addr, len, writable ? (PROT_READ | PROT_WRITE) : PROT_READ);
+    VM_FAIL_WITH_ERRNO_IF(r != 0, "Failed to change the protection of JIT data memory");
+}
+
+void JitMemoryAllocator::SetLargeAllocationHeaderProtection(JitMemoryLargeAllocationHeader::DoublyLink* link, bool writable)
+{
+    if (!m_isWriteProtected || link == &m_laAnchor)
+    {
+        return;
+    }
+    // The header always sits in the first 4KB of the allocation
+    //
+    SetProtection(JitMemoryLargeAllocationHeader::GetFromLinkNode(link), 4096, writable);
+}
+
+void JitMemoryAllocator::WriteProtect(void* addr)
+{
+    assert(m_isWriteProtected);
+    JitMemoryPageHeaderBase* hb = JitMemoryPageHeaderBase::Get(addr);
+    if (hb->IsLargeAllocation())
+    {
+        SetProtection(hb, hb->AsLAHeader()->GetSize(), false /*writable*/);
+    }
+    else
+    {
+        SetProtection(hb, JitMemoryPageHeaderBase::x_pageSize, false /*writable*/);
+    }
+}
+
 void JitMemoryAllocator::Shutdown()
 {
     while (m_laAnchor.next != &m_laAnchor)
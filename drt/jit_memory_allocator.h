@@ -332,6 +332,10 @@ public:
         m_totalOsMemoryUsage = 0;
         m_reservedRangeCur = 0;
         m_reservedRangeEnd = 0;
+        m_committedRangeEnd = 0;
+        m_useHugePages = false;
+        m_isExecutable = true;
+        m_isWriteProtected = false;
         m_laAnchor.prev = &m_laAnchor;
         m_laAnchor.next = &m_laAnchor;
     }
@@ -341,6 +345,50 @@ public:
         Shutdown();
     }
 
+    // When enabled, the memory pages for small allocations are carved out of 2MB-aligned chunks advised with MADV_HUGEPAGE,
+    // so the kernel may back each chunk with one transparent huge page. This reduces iTLB misses when the code is spread
+    // over many pages, at the cost of committing memory in 2MB granularity.
+    //
+    // Must be called before anything is allocated.
+    //
+    void SetUseTransparentHugePages(bool value)
+    {
+        assert(m_reservedRangeCur == 0 && m_reservedRangeEnd == 0);
+        m_useHugePages = value;
+    }
+
+    // By default the allocated memory is readable, writable and executable.
+    // If set to false, the allocated memory is only readable and writable, which is used for JIT data that is never executed.
+    //
+    // Must be called before anything is allocated.
+    //
+    void SetIsExecutable(bool value)
+    {
+        assert(m_reservedRangeCur == 0 && m_reservedRangeEnd == 0 && m_laAnchor.next == &m_laAnchor);
+        m_isExecutable = value;
+    }
+
+    // If set, the allocated memory is read-only except when it is being written: the memory returned by the allocation
+    // functions is writable, and the caller must call WriteProtect once it has finished writing it.
+    // This is only supported for non-executable memory without huge pages, and is used for JIT data that is only written by the codegen.
+    //
+    // Note that the protection is per page, so while an allocation is being written, the other allocations in the
+    // same 16KB page are also writable.
+    //
+    // Must be called before anything is allocated.
+    //
+    void SetIsWriteProtected(bool value)
+    {
+        assert(m_reservedRangeCur == 0 && m_reservedRangeEnd == 0 && m_laAnchor.next == &m_laAnchor);
+        assert(!value || (!m_isExecutable && !m_useHugePages));
+        m_isWriteProtected = value;
+    }
+
+    // Make the memory at 'addr' (which must be an allocation returned by this allocator) read-only again.
+    // Only valid if write protection is enabled.
+    //
+    void WriteProtect(void* addr);
+
     // Allocate a piece of memory with size x_jit_mem_alloc_stepping_array[wantedStepping]
     // Directly responsible for 'm_totalUsedMemory' accounting
     //
@@ -350,8 +398,14 @@ public:
         JitMemoryPageHeader* freelist = m_freeList[wantedStepping];
         if (unlikely(freelist == nullptr))
         {
+            // Note that a new page is always writable
+            //
             freelist = AllocateNewPageForStepping(wantedStepping);
         }
+        else if (m_isWriteProtected)
+        {
+            SetProtection(freelist, JitMemoryPageHeaderBase::x_pageSize, true /*writable*/);
+        }
         assert(freelist == m_freeList[wantedStepping]);
 
         assert(freelist != nullptr && freelist->HasFreeCell());
@@ -399,7 +453,15 @@ public:
             m_totalUsedMemory -= hdr->GetSize();
             assert(m_totalOsMemoryUsage >= hdr->GetSize());
             m_totalOsMemoryUsage -= hdr->GetSize();
+            // Unlinking the allocation writes the headers of its neighbors in the list
+            //
+            JitMemoryLargeAllocationHeader::DoublyLink* prev = hdr->m_link.prev;
+            JitMemoryLargeAllocationHeader::DoublyLink* next = hdr->m_link.next;
+            SetLargeAllocationHeaderProtection(prev, true /*writable*/);
+            SetLargeAllocationHeaderProtection(next, true /*writable*/);
             hdr->Destroy();
+            SetLargeAllocationHeaderProtection(prev, false /*writable*/);
+            SetLargeAllocationHeaderProtection(next, false /*writable*/);
         }
         else
         {
@@ -407,6 +469,11 @@ public:
             assert(m_totalUsedMemory >= hdr->m_cellSize);
             m_totalUsedMemory -= hdr->m_cellSize;
 
+            if (m_isWriteProtected)
+            {
+                SetProtection(hdr, JitMemoryPageHeaderBase::x_pageSize, true /*writable*/);
+            }
+
             bool shouldInsertToFreeList = hdr->FreeCell(addr);
             if (unlikely(shouldInsertToFreeList))
             {
@@ -417,6 +484,11 @@ public:
                 hdr->SetNextPage(m_freeList[stepping]);
                 m_freeList[stepping] = hdr;
             }
+
+            if (m_isWriteProtected)
+            {
+                SetProtection(hdr, JitMemoryPageHeaderBase::x_pageSize, false /*writable*/);
+            }
         }
     }
 
@@ -459,6 +531,15 @@ private:
     //
     void Shutdown();
 
+    // Only used if write protection is enabled: make [addr, addr + len) writable or read-only
+    //
+    void SetProtection(void* addr, size_t len, bool writable);
+
+    // Only used if write protection is enabled: make the header of a large allocation writable or read-only.
+    // No-op if 'link' is the list anchor or if write protection is not enabled.
+    //
+    void SetLargeAllocationHeaderProtection(JitMemoryLargeAllocationHeader::DoublyLink* link, bool writable);
+
     JitMemoryPageHeader* m_freeList[x_jit_mem_alloc_total_steppings];
 
     // The current size of memory the user has used.
@@ -479,9 +560,26 @@ private:
     static constexpr size_t x_reserveRangeSize = 16 * 1024 * 1024;
     static_assert(x_reserveRangeSize % JitMemoryPageHeaderBase::x_pageSize == 0);
 
+    static constexpr size_t x_hugePageSize = 2 * 1024 * 1024;
+    static_assert(x_reserveRangeSize % x_hugePageSize == 0);
+    static_assert(x_hugePageSize % JitMemoryPageHeaderBase::x_pageSize == 0);
+
     uint64_t m_reservedRangeCur;
     uint64_t m_reservedRangeEnd;
 
+    // Only used if m_useHugePages is true: [m_reservedRangeCur, m_committedRangeEnd) has been turned into usable memory
+    // but not yet handed out as pages. This memory is not counted in 'm_totalOsMemoryUsage'.
+    //
+    uint64_t m_committedRangeEnd;
+    bool m_useHugePages;
+    bool m_isExecutable;
+    bool m_isWriteProtected;
+
+    int GetProtFlags()
+    {
+        return m_isExecutable ? (PROT_READ | PROT_WRITE | PROT_EXEC) : (PROT_READ | PROT_WRITE);
+    }
+
     // A circular doubly-linked list chaining all the large allocations, for clean shutdown
     //
     JitMemoryLargeAllocationHeader::DoublyLink m_laAnchor;
@@ -0,0 +1,77 @@
+do --- stops at the first hole
+  local t = { 1, 2, nil, 4 }
+  local n = 0
+  for i, v in ipairs(t) do
+    assert(i == v)
+    n = n + 1
+  end
+  assert(n == 2)
+end
+
+do --- ignores __index metamethod
+  local t = setmetatable({ 1, 2 }, { __index = function(_, k) return k end })
+  local n = 0
+  for i, v in ipairs(t) do
+    assert(i == v)
+    n = n + 1
+  end
+  assert(n == 2)
+end
+
+do --- sees modifications made by the loop body
+  local t = { 1, 2, 3 }
+  local n = 0
+  for i, v in ipairs(t) do
+    if i < 10 then
+      t[i + 1] = v + 1
+    end
+    n = n + 1
+  end
+  assert(n == 10)
+  for i = 5, 10 do t[i] = nil end
+  n = 0
+  for i in ipairs(t) do
+    t[3] = nil
+    n = n + 1
+  end
+  assert(n == 2)
+end
+
+do --- hash part and non-integer keys
+  local t = {}
+  t[1] = 'a'
+  t[2] = 'b'
+  t[2.5] = 'c'
+  t.x = 'd'
+  local s = ''
+  for _, v in ipairs(t) do
+    s = s .. v
+  end
+  assert(s == 'ab')
+end
+
+do --- a user function named ipairs
+  local ipairs = function(t)
+    return function(s, i)
+      if i < 3 then return i + 1, s[i + 1] end
+    end, t, 0
+  end
+  local n = 0
+  for i, v in ipairs({ 5, 6, nil, 8 }) do
+    n = n + 1
+    assert(i == n)
+  end
+  assert(n == 3)
+end
+
+do --- ipairs iterator obtained manually, with non-zero start
+  local iter, t = ipairs({ 1, 2, 3, 4 })
+  local n = 0
+  for i, v in iter, t, 2 do
+    assert(i == v and i > 2)
+    n = n + 1
+  end
+  assert(n == 2)
+end
+
+print('test end')
@@ -0,0 +1,62 @@
+local Point = {}
+Point.__index = Point
+
+function Point.new(x, y)
+	return setmetatable({ x = x, y = y }, Point)
+end
+
+function Point:len2()
+	return self.x * self.x + self.y * self.y
+end
+
+local function sumLen2(pts)
+	local s = 0
+	for i = 1, #pts do
+		s = s + pts[i]:len2()
+	end
+	return s
+end
+
+local pts = {}
+for i = 1, 10 do
+	pts[i] = Point.new(i, 1)
+end
+
+print('-- test 1 --')
+print(sumLen2(pts))
+print(sumLen2(pts))
+
+print('-- test 2 --')
+-- redefine the method in the __index table
+Point.len2 = function(self) return self.x end
+print(sumLen2(pts))
+
+print('-- test 3 --')
+-- add more fields to the __index table so its hidden class changes
+Point.foo = 1
+Point.bar = 2
+print(sumLen2(pts))
+
+print('-- test 4 --')
+-- replace '__index' with another table
+local Point2 = { len2 = function(self) return 100 end }
+Point.__index = Point2
+print(sumLen2(pts))
+
+print('-- test 5 --')
+-- the property in the __index table becomes nil, falls back to '__index' of its metatable
+Point2.len2 = nil
+setmetatable(Point2, { __index = function(t, k) return function() return 7 end end })
+print(sumLen2(pts))
+
+print('-- test 6 --')
+-- own property shadows the __index table
+Point.__index = Point
+Point.len2 = function(self) return 1 end
+pts[3].len2 = function(self) return 1000 end
+print(sumLen2(pts))
+
+print('-- test 7 --')
+-- '__index' becomes a function
+Point.__index = function(t, k) return function() return 2 end end
+print(sumLen2(pts))
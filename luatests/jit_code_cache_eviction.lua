@@ -0,0 +1,12 @@
+local fns = {}
+for k = 1, 20 do
+	fns[k] = load("return function(n) local s = 0 for i = 1, n do s = s + i * " .. k .. " end return s end")()
+end
+
+local total = 0
+for round = 1, 3 do
+	for k = 1, 20 do
+		total = total + fns[k](100000)
+	end
+end
+print(total)
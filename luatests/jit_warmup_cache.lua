@@ -0,0 +1,17 @@
+local function hot(n)
+	local s = 0
+	for i = 1, n do
+		s = s + i % 7
+	end
+	return s
+end
+
+local function cold(n)
+	return n + 1
+end
+
+local total = 0
+for k = 1, 100 do
+	total = total + hot(10000)
+end
+print(total, cold(1))
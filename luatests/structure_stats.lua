@@ -0,0 +1,27 @@
+local s0 = debug.structurestats()
+print(type(s0.structures), s0.structures > 0, s0.transitions > 0)
+
+-- Objects with data-dependent keys make the transition tree fan out,
+-- which should eventually make new objects go to dictionary mode
+--
+local objs = {}
+for i = 1, 1000 do
+	local o = { x = 1 }
+	o["k" .. i] = i
+	objs[i] = o
+end
+
+local s1 = debug.structurestats()
+print(s1.fanoutdictionaries > s0.fanoutdictionaries)
+print(s1.dictionaries >= s1.fanoutdictionaries)
+print(s1.structures - s0.structures < 1000)
+
+-- Objects in dictionary mode must still behave correctly
+--
+local sum = 0
+for i = 1, 1000 do
+	local o = objs[i]
+	o.y = 2
+	sum = sum + o["k" .. i] + o.x + o.y
+end
+print(sum)
@@ -0,0 +1,42 @@
+-- method found directly in the object
+local o = { v = 1 }
+function o:get() return self.v end
+function o:add(x) self.v = self.v + x; return self end
+print(o:get(), o:add(2):add(3):get())
+
+-- method found via the __index table of the metatable (the common OOP pattern)
+local Point = {}
+Point.__index = Point
+function Point.new(x, y) return setmetatable({ x = x, y = y }, Point) end
+function Point:norm2() return self.x * self.x + self.y * self.y end
+local s = 0
+for i = 1, 100 do
+	s = s + Point.new(i, i + 1):norm2()
+end
+print(s)
+
+-- method found via an __index function
+local proxy = setmetatable({}, { __index = function(t, k) return function(self, a) return k .. a end end })
+print(proxy:foo("bar"), proxy:baz(1))
+
+-- method on a string, via the string metatable
+local str = "hello"
+print(str:upper(), ("abc"):rep(2), str:sub(2, 3))
+
+-- the object expression is a temporary
+local function make() return o end
+print(make():get())
+
+-- the method is looked up before the arguments are evaluated
+local t = {}
+function t:f(x) return "old" .. x end
+print(t:f((function() t.f = function(_, x) return "new" .. x end; return 1 end)()))
+print(t:f(2))
+
+-- calling a missing method errors
+print((pcall(function() return o:nonexistent() end)))
+
+-- multiple results and variadic arguments
+local m = { }
+function m:pack(...) return select('#', ...), ... end
+print(m:pack(1, nil, 3))
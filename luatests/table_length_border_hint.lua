@@ -0,0 +1,53 @@
+-- All tables below are built out of order, so they are not continuous arrays,
+-- but they always hold a single sequence, so the result of '#' is well-defined
+--
+
+print("-- test 1 --")
+local t = {}
+t[2] = "b"
+t[1] = "a"
+print(#t)
+local s = 0
+for i = 1, 100 do
+	t[#t + 1] = i
+	s = s + #t
+end
+print(#t, s)
+for i = 1, 50 do
+	t[#t] = nil
+	s = s + #t
+end
+print(#t, s)
+
+print("-- test 2 --")
+t = {}
+t[5000] = 5000
+for i = 1, 4999 do
+	t[i] = i
+end
+print(#t)
+for i = 1, 100 do
+	t[#t + 1] = i
+end
+print(#t)
+for i = 1, 3000 do
+	t[#t] = nil
+end
+print(#t)
+
+print("-- test 3 --")
+t = {}
+t[3] = 3
+t[2] = 2
+t[1] = 1
+table.insert(t, 4)
+print(#t, t[4])
+table.remove(t)
+table.remove(t)
+print(#t, t[3])
+for i = 1, 10 do
+	t[i] = nil
+end
+print(#t)
+t[1] = 1
+print(#t)
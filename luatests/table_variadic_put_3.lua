@@ -0,0 +1,64 @@
+local function pack(...)
+	return { ... }
+end
+
+local function packAfter(...)
+	return { "a", "b", ... }
+end
+
+local function sum(t, n)
+	local s = 0
+	for i = 1, n do
+		if t[i] ~= nil then
+			s = s + t[i]
+		end
+	end
+	return s
+end
+
+print("-- test 1 --")
+local t = pack(1, 2, 3)
+print(#t, t[1], t[2], t[3], t[4])
+t[#t + 1] = 4.5
+print(#t, t[4])
+t = pack(1.5, 2.5)
+print(#t, t[1], t[2])
+t = pack("x", 1, 2.5, true)
+print(#t, t[1], t[2], t[3], t[4])
+
+print("-- test 2 --")
+t = pack()
+print(#t, next(t))
+t = pack(nil, nil)
+print(#t, next(t))
+t = pack(1, 2, nil, nil)
+print(#t, t[1], t[2], t[3])
+
+print("-- test 3 --")
+t = pack(1, nil, 3)
+print(t[1], t[2], t[3], t[4])
+t[2] = 2
+print(#t, sum(t, 3))
+t = pack(nil, 2)
+print(t[1], t[2])
+t[1] = 1
+print(#t)
+
+print("-- test 4 --")
+t = packAfter(1, 2, 3)
+print(#t, t[1], t[2], t[3], t[5])
+t = packAfter()
+print(#t, t[1], t[2], t[3])
+
+print("-- test 5 --")
+local big = {}
+for i = 1, 3000 do
+	big[i] = i
+end
+t = pack(unpack(big))
+print(#t, sum(t, 3000))
+t = packAfter(unpack(big))
+print(#t, t[1], t[3], t[3002])
+big[1500] = nil
+t = pack(unpack(big, 1, 3000))
+print(t[1499], t[1500], t[1501], sum(t, 3000))
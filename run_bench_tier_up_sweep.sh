@@ -0,0 +1,112 @@
+#!/bin/bash
+# Runs the benchmark suite once for each interpreter tier-up setting, and reports the total running time of each setting.
+# This is used to tune the interpreter tier-up thresholds, see 'x_interpreter_tier_up_threshold_bytecode_length_multiplier'.
+#
+# usage: ./run_bench_tier_up_sweep.sh [setting]...
+# where each setting is either a tier-up policy name (e.g., 'adaptive') or a multiplier (e.g., '20').
+#
+TASKSET_PIN_CPU_CORE=4
+
+if [ ! -f "luajitr" ]; then
+	echo "[ERROR] Benchmark executable 'luajitr' not found! Did you run the build?"
+	exit
+fi
+
+if [ -z "$(./luajitr -v 2>&1 | grep 'release build')" ]; then 
+	echo "[ERROR] Benchmark executable 'luajitr' is not built in release mode!"
+	echo "[ERROR] You should only run benchmark using a release build."
+	exit
+fi 
+
+if [ ! -f "luabench/FASTA_5000000" ]; then
+	lua luabench/fasta.lua 5000000 > luabench/FASTA_5000000
+fi
+
+SETTINGS=("$@")
+if [ ${#SETTINGS[@]} -eq 0 ]; then
+	SETTINGS=(2 5 10 20 40 80 160 adaptive)
+fi
+
+# Returns the running time of one benchmark in seconds
+#
+run_bench_once() {
+	START=$(date +%s.%N)
+	taskset -c $TASKSET_PIN_CPU_CORE "$@" < luabench/FASTA_5000000 > /dev/null 2>&1
+	RET_CODE=$?
+	END=$(date +%s.%N)
+	if [ $RET_CODE -ne 0 ]; then
+		echo "[ERROR] Benchmark failed with return code ${RET_CODE}!" >&2
+		echo "Benchmark command: $@" >&2
+		exit 1
+	fi
+	echo "$END - $START" | bc
+}
+
+BENCHMARKS=(
+	"array3d.lua 300 packed"
+	"binary-trees-num.lua 16"
+	"binary-trees-name.lua 15"
+	"bounce.lua 3000"
+	"cd.lua"
+	"chameneos.lua 1e7"
+	"coroutine-ring.lua 2e7"
+	"deltablue.lua"
+	"fannkuch.lua 11"
+	"fasta.lua 5e6"
+	"fixpoint-fact.lua 1000"
+	"havlak.lua"
+	"heapsort.lua 1 3000000"
+	"json.lua"
+	"k-nucleotide.lua 5e6"
+	"life.lua 2000"
+	"linear-sieve.lua 3e7"
+	"list.lua"
+	"mandelbrot.lua 3000"
+	"mandel-metatable.lua 256"
+	"nbody.lua 5e6"
+	"nsieve.lua 12"
+	"partialsums.lua 3e7"
+	"permute.lua"
+	"pidigits-nogmp.lua 5000"
+	"qt.lua 14"
+	"quadtree-2.lua 14"
+	"queen.lua 12"
+	"ray.lua 9"
+	"ray-prop.lua 9"
+	"recursive-fib-uv.lua 40"
+	"recursive-fib-gv.lua 40"
+	"revcomp.lua 5e6"
+	"richard.lua"
+	"scimark-fft.lua 10"
+	"scimark-lu.lua 5"
+	"scimark-sor.lua 5"
+	"scimark-sparse.lua 300"
+	"series.lua 5000"
+	"spectral-norm.lua 2000"
+	"storage.lua"
+	"table-sort.lua 5e6"
+	"table-sort-cmp.lua 1e6"
+	"towers.lua"
+)
+
+echo -n > benchmark_tier_up_sweep.log
+
+for SETTING in "${SETTINGS[@]}"; do
+	if [[ "$SETTING" =~ ^[0-9]+$ ]]; then
+		OPTION="--tier-up-multiplier=$SETTING"
+	else
+		OPTION="--tier-up-policy=$SETTING"
+	fi
+	echo "### $OPTION" | tee -a benchmark_tier_up_sweep.log
+	TOTAL=0
+	for BENCH in "${BENCHMARKS[@]}"; do
+		set -- $BENCH
+		FILE_PATH="luabench/$1"
+		shift
+		T=$(run_bench_once ./luajitr $OPTION $FILE_PATH "$@") || exit
+		echo "$BENCH: $T" >> benchmark_tier_up_sweep.log
+		TOTAL=$(echo "$TOTAL + $T" | bc)
+		sleep 1
+	done
+	echo "Total: $TOTAL" | tee -a benchmark_tier_up_sweep.log
+done
@@ -49,9 +49,34 @@ public:
         return result;
     }
 
+    // Values in [x_minBorderHintEncoding, -1] are never valid GeneralHeapPointers (see GeneralHeapPointer::x_negMaxValue),
+    // so for a non-continuous array without sparse map we use them to store a hint of the last known border
+    //
+    static constexpr int32_t x_minBorderHintEncoding = -(1 << 29);
+    static_assert(GeneralHeapPointer<void>::x_negMaxValue < x_minBorderHintEncoding);
+
     bool HasSparseMap()
     {
-        return m_arrayLengthIfContinuous < - 1;
+        return m_arrayLengthIfContinuous < x_minBorderHintEncoding;
+    }
+
+    // The border hint is only a hint: users must validate it before use
+    //
+    uint32_t GetBorderHint()
+    {
+        assert(!IsContinuous() && !HasSparseMap());
+        return static_cast<uint32_t>(-1 - m_arrayLengthIfContinuous);
+    }
+
+    void SetBorderHint(uint32_t hint)
+    {
+        assert(!IsContinuous() && !HasSparseMap());
+        if (unlikely(hint > static_cast<uint32_t>(-1 - x_minBorderHintEncoding)))
+        {
+            hint = 0;
+        }
+        m_arrayLengthIfContinuous = -1 - static_cast<int32_t>(hint);
+        assert(!IsContinuous() && !HasSparseMap() && GetBorderHint() == hint);
     }
 
     HeapPtr<ArraySparseMap> GetSparseMap()
@@ -60,8 +85,9 @@ public:
         return GeneralHeapPointer<ArraySparseMap> { m_arrayLengthIfContinuous }.As();
     }
 
-    // If == - 1, it means the vector part is not continuous
-    // If < - 1, it means the vector part is not continuous and there is a sparse map,
+    // If in [x_minBorderHintEncoding, -1], it means the vector part is not continuous and there is no sparse map,
+    //     and the value encodes a border hint 'h' as '-1 - h' (so -1 means a hint of 0)
+    // If < x_minBorderHintEncoding, it means the vector part is not continuous and there is a sparse map,
     //     and the value can be interpreted as a GeneralHeapPointer<ArraySparseMap>
     // If >= 0, it means the vector part is continuous and has no sparse map.
     //     That is, range [x_arrayBaseOrd, m_arrayLengthIfContinuous + x_arrayBaseOrd) are all non-nil values, and everything else are nils
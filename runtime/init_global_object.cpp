@@ -56,6 +56,7 @@
   , setlocal                            \
   , setmetatable                        \
   , setupvalue                          \
+  , structurestats                      \
   , traceback                           \
 
 #define LUA_LIB_IO_FUNCTION_LIST        \
@@ -245,6 +246,7 @@ UserHeapPointer<TableObject> CreateGlobalObject(VM* vm)
     vm->InitializeLibFn<VM::LibFn::BaseToString>(TValue::Create<tFunction>(libfn_base_tostring));
     vm->InitializeLibFn<VM::LibFn::BaseLoad>(TValue::Create<tFunction>(libfn_base_load));
     vm->InitializeLibFn<VM::LibFn::BaseNextValidationOk>(TValue::Create<tTable>(TableObject::CreateEmptyTableObject(vm, 0U /*inlineCapacity*/, 0 /*initialButterflyArrayPartCapacity*/)));
+    vm->InitializeLibFn<VM::LibFn::BaseIPairsIterValidationOk>(TValue::Create<tTable>(TableObject::CreateEmptyTableObject(vm, 0U /*inlineCapacity*/, 0 /*initialButterflyArrayPartCapacity*/)));
     vm->m_stringNameForToStringMetamethod = vm->CreateStringObjectFromRawCString("__tostring");
     vm->m_toStringString = vm->CreateStringObjectFromRawCString("tostring");
 
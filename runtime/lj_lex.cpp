@@ -675,13 +675,13 @@ void lj_lex_init(VM* vm)
     }
 }
 
-ParseResult WARN_UNUSED ParseLuaScript(CoroutineRuntimeContext* coroCtx, lua_Reader rd, void* ud)
+ParseResult WARN_UNUSED ParseLuaScript(CoroutineRuntimeContext* coroCtx, lua_Reader rd, void* ud, const char* chunkName)
 {
     SimpleTempStringStream ss;
     LexState ls;
     ls.rfunc = rd;
     ls.rdata = ud;
-    ls.chunkarg = "?";
+    ls.chunkarg = chunkName;
     ls.mode = nullptr;
     ls.sb = &ss;
 
@@ -911,7 +911,7 @@ ParseResult WARN_UNUSED ParseLuaScriptFromFile(CoroutineRuntimeContext* ctx, con
 
     LuaSimpleFileReaderState state;
     state.fp = fp;
-    ParseResult res = ParseLuaScript(ctx, Parser_LuaSimpleFileReader, &state);
+    ParseResult res = ParseLuaScript(ctx, Parser_LuaSimpleFileReader, &state, fileName /*chunkName*/);
     fclose(fp);
 
     return res;
@@ -186,6 +186,8 @@
     _(TGETS,	dst,	var,	str,	index) \
     _(TGETB,	dst,	var,	lit,	index) \
     _(TGETR,	dst,	var,	var,	index) \
+    /* TGETM: method lookup for 'obj:method(...)', A = call base, B = obj, C = method name */ \
+    _(TGETM,	base,	var,	str,	index) \
     _(TSETV,	var,	var,	var,	newindex) \
     _(TSETS,	var,	var,	str,	newindex) \
     _(TSETB,	var,	var,	lit,	newindex) \
@@ -1179,16 +1181,18 @@ static void bcemit_store(FuncState *fs, ExpDesc *var, ExpDesc *e)
 }
 
 /* Emit method lookup expression. */
+/* Unlike LuaJIT, which emits a MOV to copy the object to the 1st argument followed by a TGETS,
+** we emit a single TGETM that does both, so the method lookup is dispatched once.
+*/
 static void bcemit_method(FuncState *fs, ExpDesc *e, ExpDesc *key)
 {
     BCReg obj = expr_toanyreg(fs, e);
     expr_free(fs, e);
     BCReg func = fs->freereg;
-    std::ignore = bcemit_AD(fs, BC_MOV, func+1+LJ_FR2, obj);  /* Copy object to 1st argument. */
     assert(expr_isstrk(key) && "bad usage");
     TValue idx = const_str(key);
     bcreg_reserve(fs, 2+LJ_FR2);
-    std::ignore = bcemit_ABC(fs, BC_TGETS, func, obj, idx);
+    std::ignore = bcemit_ABC(fs, BC_TGETM, func, obj, idx);  /* Also copies object to 1st argument. */
     e->u.s.info = func;
     e->k = VNONRELOC;
 }
@@ -2768,6 +2772,16 @@ static void fs_fixup_bc(FuncState *fs, UnlinkedCodeBlock* ucb, BytecodeBuilder&
             });
             break;
         }
+        case BC_TGETM:
+        {
+            bw.CreateTableGetMethod({
+                .base = Local { bc_a(ins) },
+                .object = Local { bc_b(ins) },
+                .index = bc_cst(ins),
+                .output = Local { bc_a(ins) }
+            });
+            break;
+        }
         case BC_TGETB:
         {
             bw.CreateTableGetByImm({
@@ -3197,6 +3211,8 @@ static UnlinkedCodeBlock* fs_finish(LexState *ls, BCLine /*line*/)
     ucb->m_numFixedArguments = fs->numparams;
     ucb->m_hasVariadicArguments = (fs->flags & PROTO_VARARG) > 0;
     ucb->m_stackFrameNumSlots = fs->framesize;
+    ucb->m_chunkName = UserHeapPointer<HeapString> { ls->chunkname };
+    ucb->m_lineDefined = static_cast<uint32_t>(fs->linedefined);
     ucb->m_bytecodeBuilder = new BytecodeBuilder();
     fs_fixup_bc(fs, ucb, *ucb->m_bytecodeBuilder, fs->pc);
 
@@ -4241,7 +4257,7 @@ static void parse_for_num(LexState *ls, HeapPtr<HeapString> varname, BCLine line
 }
 
 /* Try to predict whether the iterator is next() and specialize the bytecode.
-** Detecting next() and pairs() by name is simplistic, but quite effective.
+** Detecting next(), pairs() and ipairs() by name is simplistic, but quite effective.
 ** The interpreter backs off if the check for the closure fails at runtime.
 */
 static int predict_next(LexState *ls, FuncState *fs, BCPos pc)
@@ -4275,7 +4291,14 @@ static int predict_next(LexState *ls, FuncState *fs, BCPos pc)
             name->m_string[0] =='n' &&
             name->m_string[1] == 'e' &&
             name->m_string[2] =='x' &&
-            name->m_string[3] =='t');
+            name->m_string[3] =='t') ||
+           (name->m_length == 6 &&
+            name->m_string[0] =='i' &&
+            name->m_string[1] == 'p' &&
+            name->m_string[2] =='a' &&
+            name->m_string[3] =='i' &&
+            name->m_string[4] =='r' &&
+            name->m_string[5] =='s');
 }
 
 /* Parse 'for' iterator. */
@@ -4456,7 +4479,7 @@ UnlinkedCodeBlock* lj_parse(LexState *ls)
 {
     FuncState fs;
     FuncScope bl;
-    ls->chunkname = VM::GetActiveVMForCurrentThread()->m_emptyString;
+    ls->chunkname = VM::GetActiveVMForCurrentThread()->CreateStringObjectFromRawCString(ls->chunkarg);
     ls->level = 0;
     fs_init(ls, &fs);
     fs.linedefined = 0;
@@ -12,7 +12,9 @@ struct ParseResult
 using lua_Reader = const char*(*)(CoroutineRuntimeContext*, void*, size_t*);
 
 void lj_lex_init(VM* vm);
-ParseResult WARN_UNUSED ParseLuaScript(CoroutineRuntimeContext* ctx, lua_Reader rd, void* ud);
+// 'chunkName' is only used to name the functions in debugging and profiling tools
+//
+ParseResult WARN_UNUSED ParseLuaScript(CoroutineRuntimeContext* ctx, lua_Reader rd, void* ud, const char* chunkName = "?");
 
 // Parse Lua script from the specified string
 //
@@ -86,6 +86,33 @@ void* WARN_UNUSED UnlinkedCodeBlock::GetInterpreterEntryPoint()
     return generated::GetGuestLanguageFunctionEntryPointForInterpreter(m_hasVariadicArguments, m_numFixedArguments);
 }
 
+uint64_t WARN_UNUSED UnlinkedCodeBlock::ComputeBaselineJitWarmupCacheKey()
+{
+    // The constant table is not hashed since it may contain heap pointers that are not stable across runs,
+    // but the bytecode refers to the constants by ordinal, so the number of constants is hashed
+    //
+    uint64_t prototype[4] = {
+        m_numFixedArguments,
+        m_hasVariadicArguments ? 1ULL : 0ULL,
+        m_stackFrameNumSlots,
+        m_cstTableLength
+    };
+    uint64_t protoHash = HashString(prototype, sizeof(prototype));
+    uint64_t bytecodeHash = HashString(m_bytecode, m_bytecodeLengthIncludingTailPadding);
+    return protoHash ^ (bytecodeHash * 0x9e3779b97f4a7c15ULL);
+}
+
+std::string WARN_UNUSED UnlinkedCodeBlock::GetDebugName()
+{
+    std::string chunkName = "?";
+    if (m_chunkName.m_value != 0)
+    {
+        HeapString* hs = TranslateToRawPointer(m_chunkName.As());
+        chunkName = std::string(reinterpret_cast<const char*>(hs->m_string), hs->m_length);
+    }
+    return chunkName + ":" + std::to_string(m_lineDefined);
+}
+
 CodeBlock* WARN_UNUSED CodeBlock::Create(VM* vm, UnlinkedCodeBlock* ucb, UserHeapPointer<TableObject> globalObject)
 {
     assert(ucb->m_bytecodeMetadataLength % 8 == 0);
@@ -110,7 +137,7 @@ CodeBlock* WARN_UNUSED CodeBlock::Create(VM* vm, UnlinkedCodeBlock* ucb, UserHea
     cb->m_dfgCodeBlock = nullptr;
     if (vm->InterpreterCanTierUpFurther())
     {
-        cb->m_interpreterTierUpCounter = x_interpreter_tier_up_threshold_bytecode_length_multiplier * ucb->m_bytecodeLengthIncludingTailPadding;
+        cb->m_interpreterTierUpCounter = static_cast<int64_t>(vm->GetInterpreterTierUpThresholdMultiplier() * ucb->m_bytecodeLengthIncludingTailPadding);
     }
     else
     {
@@ -124,10 +151,17 @@ CodeBlock* WARN_UNUSED CodeBlock::Create(VM* vm, UnlinkedCodeBlock* ucb, UserHea
         md->Init();
     });
 
-    // Immediately compile the CodeBlock to baseline JIT code if requested by user.
+    // Immediately compile the CodeBlock to baseline JIT code if requested by user,
+    // or if the baseline JIT warm-up cache says the function got compiled in a previous run of the VM.
     // Note that this must be done after we have set up all the fields in the CodeBlock
     //
-    if (vm->IsEngineStartingTierBaselineJit())
+    bool shouldCompileNow = vm->IsEngineStartingTierBaselineJit();
+    if (!shouldCompileNow && vm->IsBaselineJitWarmupCacheEnabled() && vm->InterpreterCanTierUpFurther())
+    {
+        shouldCompileNow = vm->IsInLoadedBaselineJitWarmupCache(ucb->ComputeBaselineJitWarmupCacheKey());
+    }
+
+    if (shouldCompileNow)
     {
         BaselineCodeBlock* bcb = deegen_baseline_jit_do_codegen(cb);
         assert(cb->m_baselineCodeBlock == bcb);
@@ -249,6 +283,21 @@ CoroutineRuntimeContext* CoroutineRuntimeContext::Create(VM* vm, UserHeapPointer
                           "Out of Memory: Allocation of length %llu failed", static_cast<unsigned long long>(bytesToAllocate));
     assert(stackArea == reinterpret_cast<uint8_t*>(stackAreaWithOverflowProtection) + x_stackOverflowProtectionAreaSize);
     r->m_stackBegin = reinterpret_cast<TValue*>(stackArea);
+    r->m_stackEnd = r->m_stackBegin + bytesToAllocate / sizeof(TValue);
+
+    // Remove the dead coroutines from the list before it would grow, so that its size stays proportional to the number of
+    // live coroutines. The capacity is doubled if less than half of the list is dead, so each push is amortized O(1).
+    //
+    std::vector<CoroutineRuntimeContext*>& coroList = vm->GetAllCoroutines();
+    if (coroList.size() == coroList.capacity() && coroList.size() > 0)
+    {
+        std::erase_if(coroList, [](CoroutineRuntimeContext* coro) { return coro->m_coroutineStatus.IsDead(); });
+        if (coroList.size() * 2 > coroList.capacity())
+        {
+            coroList.reserve(coroList.capacity() * 2);
+        }
+    }
+    coroList.push_back(r);
     return r;
 }
 
@@ -257,7 +306,11 @@ BaselineCodeBlock* WARN_UNUSED BaselineCodeBlock::Create(CodeBlock* cb,
                                                          uint32_t slowPathDataStreamLength,
                                                          void* jitCodeEntry,
                                                          void* jitRegionStart,
-                                                         uint32_t jitRegionSize)
+                                                         uint32_t jitRegionSize,
+                                                         void* jitSlowPathRegionStart,
+                                                         uint32_t jitSlowPathRegionSize,
+                                                         void* jitDataSecRegionStart,
+                                                         uint32_t jitDataSecRegionSize)
 {
     size_t numEntriesInConstantTable = cb->m_owner->m_cstTableLength;
     static_assert(alignof(BaselineCodeBlock) == 8);         // the computation below relies on this
@@ -265,7 +318,20 @@ BaselineCodeBlock* WARN_UNUSED BaselineCodeBlock::Create(CodeBlock* cb,
     sizeToAllocate = RoundUpToMultipleOf<8>(sizeToAllocate);
 
     VM* vm = VM::GetActiveVMForCurrentThread();
-    uint8_t* addressBegin = TranslateToRawPointer(vm, vm->AllocFromSystemHeap(static_cast<uint32_t>(sizeToAllocate)).AsNoAssert<uint8_t>());
+    uint8_t* addressBegin;
+    BaselineCodeBlock* recycled = vm->TakeJettisonedBaselineCodeBlock(cb);
+    if (recycled != nullptr && recycled->m_numBytecodes == numBytecodes && recycled->m_slowPathDataStreamLength == slowPathDataStreamLength)
+    {
+        // The function is compiled again after its JIT code has been evicted, reuse the memory of the old BaselineCodeBlock.
+        // The size should always match since the bytecode of the function never changes, but if it does not, we simply
+        // allocate a new one, and the old one is leaked (the system heap cannot free memory).
+        //
+        addressBegin = reinterpret_cast<uint8_t*>(recycled) - sizeof(TValue) * numEntriesInConstantTable;
+    }
+    else
+    {
+        addressBegin = TranslateToRawPointer(vm, vm->AllocFromSystemHeap(static_cast<uint32_t>(sizeToAllocate)).AsNoAssert<uint8_t>());
+    }
     memcpy(addressBegin, cb->m_owner->m_cstTable, sizeof(TValue) * numEntriesInConstantTable);
 
     BaselineCodeBlock* res = reinterpret_cast<BaselineCodeBlock*>(addressBegin + sizeof(TValue) * numEntriesInConstantTable);
@@ -279,6 +345,12 @@ BaselineCodeBlock* WARN_UNUSED BaselineCodeBlock::Create(CodeBlock* cb,
     res->m_slowPathDataStreamLength = slowPathDataStreamLength;
     res->m_jitRegionStart = jitRegionStart;
     res->m_jitRegionSize = jitRegionSize;
+    res->m_jitSlowPathRegionStart = jitSlowPathRegionStart;
+    res->m_jitSlowPathRegionSize = jitSlowPathRegionSize;
+    res->m_jitDataSecRegionStart = jitDataSecRegionStart;
+    res->m_jitDataSecRegionSize = jitDataSecRegionSize;
+    res->m_recentlyUsed = 0;
+    res->m_compilationTimeNs = 0;
 
     TestAssert(cb->m_baselineCodeBlock == nullptr);
     cb->m_baselineCodeBlock = res;
@@ -311,6 +383,20 @@ JitCallInlineCacheEntry* WARN_UNUSED JitCallInlineCacheEntry::Create(VM* vm,
     assert(entry->GetJitRegionStart() == regionVoidPtr);
     assert(entry->GetIcTrait() == trait);
 
+    if (vm->GetPerfJitCodeMap() != nullptr)
+    {
+        std::string name = "lua:call IC stub -> ";
+        if (targetExecutableCode->IsBytecodeFunction())
+        {
+            name += static_cast<CodeBlock*>(targetExecutableCode)->m_owner->GetDebugName();
+        }
+        else
+        {
+            name += "native function";
+        }
+        vm->GetPerfJitCodeMap()->RecordCodeWithoutCodeBytes(regionVoidPtr, x_jit_mem_alloc_stepping_array[trait->m_jitCodeAllocationLengthStepping], name.c_str());
+    }
+
     assert(!entry->IsOnDoublyLinkedList());
     if (targetExecutableCode->IsBytecodeFunction())
     {
@@ -162,9 +162,10 @@ public:
     //
     UserHeapPointer<TableObject> m_globalObject;
 
-    // The beginning of the stack
+    // The stack is [m_stackBegin, m_stackEnd)
     //
     TValue* m_stackBegin;
+    TValue* m_stackEnd;
 };
 
 UserHeapPointer<TableObject> CreateGlobalObject(VM* vm);
@@ -520,6 +521,8 @@ public:
         ucb->m_parent = nullptr;
         ucb->m_defaultCodeBlock = nullptr;
         ucb->m_parserUVGetFixupList = nullptr;
+        ucb->m_chunkName = UserHeapPointer<HeapString>();
+        ucb->m_lineDefined = 0;
         return ucb;
     }
 
@@ -560,6 +563,16 @@ public:
 
     void* WARN_UNUSED GetInterpreterEntryPoint();
 
+    // The key of this function in the baseline JIT warm-up cache (see VM::LoadBaselineJitWarmupCache).
+    // This is a hash of the bytecode and the function prototype, so it is stable across runs as long as the function is unchanged.
+    // A collision only causes a function to be compiled by the baseline JIT earlier than needed.
+    //
+    uint64_t WARN_UNUSED ComputeBaselineJitWarmupCacheKey();
+
+    // Returns '<chunk name>:<first line of the function definition>', used to name the function in profiling tools
+    //
+    std::string WARN_UNUSED GetDebugName();
+
     // For assertion purpose only
     //
     bool m_uvFixUpCompleted;
@@ -584,6 +597,12 @@ public:
     uint32_t m_bytecodeMetadataLength;
     uint32_t m_stackFrameNumSlots;
 
+    // The name of the chunk that defines this function (null if unknown),
+    // and the line where the function definition starts (0 for the main chunk)
+    //
+    UserHeapPointer<HeapString> m_chunkName;
+    uint32_t m_lineDefined;
+
     // Only used during parsing. Always nullptr at runtime.
     // It doesn't have to sit in this struct but the memory consumption of this struct simply shouldn't matter.
     //
@@ -614,7 +633,11 @@ public:
                                                  uint32_t slowPathDataStreamLength,
                                                  void* jitCodeEntry,
                                                  void* jitRegionStart,
-                                                 uint32_t jitRegionSize);
+                                                 uint32_t jitRegionSize,
+                                                 void* jitSlowPathRegionStart,
+                                                 uint32_t jitSlowPathRegionSize,
+                                                 void* jitDataSecRegionStart,
+                                                 uint32_t jitDataSecRegionSize);
 
     static constexpr size_t GetTrailingArrayOffset()
     {
@@ -696,6 +719,36 @@ public:
         return GetBytecodeIndexFromBytecodePtrLower32Bits(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(bytecodePtr)));
     }
 
+    // Return the bytecode index whose SlowPathData contains the given address, where slowPathDataPtr32 is the lower 32 bits of the address
+    // (e.g., the value stored in StackFrameHeader::m_callerBytecodePtr by a call from the JIT slow path).
+    // Returns -1 if the address is not in the SlowPathData stream.
+    //
+    size_t WARN_UNUSED GetBytecodeIndexFromSlowPathDataPtrLower32Bits(uint32_t slowPathDataPtr32)
+    {
+        uint32_t targetOffset = slowPathDataPtr32 - static_cast<uint32_t>(reinterpret_cast<uintptr_t>(this));
+        uint32_t streamStartOffset = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(GetSlowPathDataStreamStart()) - reinterpret_cast<uintptr_t>(this));
+        if (m_numBytecodes == 0 || targetOffset < streamStartOffset || targetOffset - streamStartOffset >= m_slowPathDataStreamLength)
+        {
+            return static_cast<size_t>(-1);
+        }
+        // The SlowPathData of the bytecodes are laid out in bytecode order, so find the last bytecode whose SlowPathData starts at or before the target
+        //
+        size_t left = 0, right = m_numBytecodes - 1;
+        while (left < right)
+        {
+            size_t mid = (left + right + 1) / 2;
+            if (m_sbIndex[mid].m_slowPathDataOffset <= targetOffset)
+            {
+                left = mid;
+            }
+            else
+            {
+                right = mid - 1;
+            }
+        }
+        return left;
+    }
+
     size_t WARN_UNUSED GetBytecodeOffsetFromBytecodeIndex(size_t bytecodeIndex)
     {
         assert(bytecodeIndex < m_numBytecodes);
@@ -715,18 +768,40 @@ public:
     uint32_t m_maxObservedNumVariadicArgs;
 
     // Currently the JIT code is layouted as follow:
-    //     [ Data Section ] [ FastPath Code ] [ SlowPath Code ]
+    //     [ FastPath Code ]      (allocated from the hot JIT memory allocator)
+    //     [ SlowPath Code ]      (allocated from the cold JIT memory allocator)
+    //     [ Data Section ]       (allocated from the non-executable JIT data memory allocator)
     //
     void* m_jitCodeEntry;
 
     CodeBlock* m_owner;
 
-    // The JIT region is [m_jitRegionStart, m_jitRegionStart + m_jitRegionSize)
+    // The JIT region for fast path is [m_jitRegionStart, m_jitRegionStart + m_jitRegionSize)
     //
     void* m_jitRegionStart;
     uint32_t m_jitRegionSize;
     uint32_t m_slowPathDataStreamLength;
 
+    // The JIT region for slow path is [m_jitSlowPathRegionStart, m_jitSlowPathRegionStart + m_jitSlowPathRegionSize)
+    //
+    void* m_jitSlowPathRegionStart;
+    uint32_t m_jitSlowPathRegionSize;
+
+    // The data section is [m_jitDataSecRegionStart, m_jitDataSecRegionStart + m_jitDataSecRegionSize)
+    // nullptr and 0 if the data section is empty
+    //
+    void* m_jitDataSecRegionStart;
+    uint32_t m_jitDataSecRegionSize;
+
+    // Set by the JIT code at function entry and at loop headers, and cleared by the code cache eviction logic,
+    // so that the eviction logic can tell which functions have not run since the last eviction
+    //
+    uint8_t m_recentlyUsed;
+
+    // How long the baseline JIT took to compile this function, used to decide when to compile it again if it is jettisoned
+    //
+    uint64_t m_compilationTimeNs;
+
     SlowPathDataAndBytecodeOffset m_sbIndex[0];
 };
 
@@ -0,0 +1,331 @@
+#include "sampling_profiler.h"
+#include "runtime_utils.h"
+#include "hash_functions.h"
+
+#include <signal.h>
+#include <sys/time.h>
+
+namespace {
+
+// The pending tick counter of the VM being profiled, or nullptr if no profiler is running
+//
+std::atomic<uint32_t*> g_samplingProfilerPendingTicks { nullptr };
+
+// Note that the handler may run on any thread of the process, and at any point of the execution (including inside
+// the profiler itself), so it must not do anything other than bumping the counter
+//
+void SamplingProfilerSignalHandler(int /*sig*/)
+{
+    uint32_t* pendingTicks = g_samplingProfilerPendingTicks.load(std::memory_order_relaxed);
+    if (pendingTicks != nullptr)
+    {
+        __atomic_fetch_add(pendingTicks, 1U, __ATOMIC_RELAXED);
+    }
+}
+
+bool WARN_UNUSED SetSamplingProfilerTimer(uint64_t intervalMicroseconds)
+{
+    struct itimerval timer;
+    timer.it_interval.tv_sec = static_cast<time_t>(intervalMicroseconds / 1000000);
+    timer.it_interval.tv_usec = static_cast<suseconds_t>(intervalMicroseconds % 1000000);
+    timer.it_value = timer.it_interval;
+    return setitimer(ITIMER_PROF, &timer, nullptr) == 0;
+}
+
+}   // anonymous namespace
+
+SamplingProfiler::~SamplingProfiler()
+{
+    Stop();
+}
+
+bool WARN_UNUSED SamplingProfiler::Start(uint32_t samplesPerSecond)
+{
+    if (m_isRunning)
+    {
+        return true;
+    }
+    if (!x_enable_sampling_profiler_safepoints)
+    {
+        LOG_WARNING("Cannot start sampling profiler: the VM is built without sampling profiler safepoints (x_enable_sampling_profiler_safepoints)");
+        return false;
+    }
+    if (samplesPerSecond == 0 || samplesPerSecond > 1000000)
+    {
+        LOG_WARNING("Invalid sampling profiler rate %u", static_cast<unsigned int>(samplesPerSecond));
+        return false;
+    }
+
+    uint32_t* expected = nullptr;
+    if (!g_samplingProfilerPendingTicks.compare_exchange_strong(expected, m_vm->GetSamplingProfilerPendingTicksAddr()))
+    {
+        LOG_WARNING("Cannot start sampling profiler: another sampling profiler is already running in the process");
+        return false;
+    }
+
+    // The handler is never uninstalled: after the timer is stopped, a SIGPROF may still be in flight,
+    // and the default action of SIGPROF is to terminate the process
+    //
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = SamplingProfilerSignalHandler;
+    sigemptyset(&sa.sa_mask);
+    // Do not make the syscalls of the program fail with EINTR
+    //
+    sa.sa_flags = SA_RESTART;
+    if (sigaction(SIGPROF, &sa, nullptr) != 0)
+    {
+        LOG_WARNING_WITH_ERRNO("Failed to install SIGPROF handler for the sampling profiler");
+        g_samplingProfilerPendingTicks.store(nullptr);
+        return false;
+    }
+
+    std::ignore = m_vm->TakeSamplingProfilerPendingTicks();
+    if (!SetSamplingProfilerTimer(1000000 / samplesPerSecond))
+    {
+        LOG_WARNING_WITH_ERRNO("Failed to set up the timer for the sampling profiler");
+        g_samplingProfilerPendingTicks.store(nullptr);
+        return false;
+    }
+
+    m_isRunning = true;
+    return true;
+}
+
+void SamplingProfiler::Stop()
+{
+    if (!m_isRunning)
+    {
+        return;
+    }
+    bool success = SetSamplingProfilerTimer(0 /*intervalMicroseconds*/);
+    LOG_WARNING_WITH_ERRNO_IF(!success, "Failed to stop the timer for the sampling profiler");
+    g_samplingProfilerPendingTicks.store(nullptr);
+    std::ignore = m_vm->TakeSamplingProfilerPendingTicks();
+    m_isRunning = false;
+}
+
+void SamplingProfiler::ClearSamples()
+{
+    m_stackCounts.clear();
+    m_numSamples = 0;
+    m_numTicks = 0;
+}
+
+size_t SamplingProfiler::StackHasher::operator()(const std::vector<uint64_t>& stack) const
+{
+    return HashString(stack.data(), stack.size() * sizeof(uint64_t));
+}
+
+uint64_t WARN_UNUSED SamplingProfiler::GetBytecodeOffsetForInterpreterLocation(CodeBlock* cb, uint32_t bytecodePtr32)
+{
+    uint32_t offset = bytecodePtr32 - static_cast<uint32_t>(reinterpret_cast<uintptr_t>(cb->GetBytecodeStream()));
+    if (offset >= cb->GetBytecodeLength())
+    {
+        return x_unknownBytecodeOffset;
+    }
+    return offset;
+}
+
+uint64_t WARN_UNUSED SamplingProfiler::GetBytecodeOffsetForBaselineJitLocation(CodeBlock* cb, uint32_t slowPathDataPtr32)
+{
+    BaselineCodeBlock* bcb = cb->m_baselineCodeBlock;
+    if (bcb == nullptr)
+    {
+        return x_unknownBytecodeOffset;
+    }
+    size_t bytecodeIndex = bcb->GetBytecodeIndexFromSlowPathDataPtrLower32Bits(slowPathDataPtr32);
+    if (bytecodeIndex == static_cast<size_t>(-1))
+    {
+        return x_unknownBytecodeOffset;
+    }
+    return bcb->GetBytecodeOffsetFromBytecodeIndex(bytecodeIndex);
+}
+
+void SamplingProfiler::RecordSample(void* stackBase, bool isBaselineJit, void* location, uint64_t numTicks)
+{
+    m_stackBuffer.clear();
+
+    // For the innermost frame, the location is given by the safepoint.
+    // For the other frames, it is the call site recorded in the callee's stack frame header.
+    //
+    bool hasLocation = (location != nullptr);
+    uint32_t location32 = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(location));
+    bool isFunctionEntry = !hasLocation;
+
+    while (m_stackBuffer.size() < x_maxStackDepth * 2)
+    {
+        StackFrameHeader* hdr = StackFrameHeader::Get(stackBase);
+        if (hdr->m_func == nullptr)
+        {
+            // This is the dummy frame at the bottom of a coroutine stack
+            //
+            break;
+        }
+
+        ExecutableCode* ec = TranslateToRawPointer(TCGet(hdr->m_func->m_executable).As());
+        if (ec->IsBytecodeFunction())
+        {
+            CodeBlock* cb = static_cast<CodeBlock*>(ec);
+            uint64_t bytecodeOffset;
+            if (isFunctionEntry)
+            {
+                bytecodeOffset = 0;
+            }
+            else if (!hasLocation)
+            {
+                bytecodeOffset = x_unknownBytecodeOffset;
+            }
+            else if (isBaselineJit)
+            {
+                bytecodeOffset = GetBytecodeOffsetForBaselineJitLocation(cb, location32);
+            }
+            else
+            {
+                bytecodeOffset = GetBytecodeOffsetForInterpreterLocation(cb, location32);
+            }
+            m_stackBuffer.push_back(reinterpret_cast<uint64_t>(cb->m_owner));
+            m_stackBuffer.push_back((bytecodeOffset << 1) | (isBaselineJit ? 1 : 0));
+        }
+        else
+        {
+            m_stackBuffer.push_back(1);
+            m_stackBuffer.push_back(x_unknownBytecodeOffset << 1);
+        }
+
+        void* callerStackBase = hdr->m_caller;
+        if (callerStackBase == nullptr)
+        {
+            break;
+        }
+
+        // Figure out which tier the caller is executing in, from the address the callee will return to
+        //
+        isFunctionEntry = false;
+        isBaselineJit = false;
+        hasLocation = true;
+        location32 = hdr->m_callerBytecodePtr.m_value;
+        StackFrameHeader* callerHdr = StackFrameHeader::Get(callerStackBase);
+        if (callerHdr->m_func != nullptr)
+        {
+            ExecutableCode* callerEc = TranslateToRawPointer(TCGet(callerHdr->m_func->m_executable).As());
+            if (callerEc->IsBytecodeFunction())
+            {
+                BaselineCodeBlock* bcb = static_cast<CodeBlock*>(callerEc)->m_baselineCodeBlock;
+                uintptr_t retAddr = reinterpret_cast<uintptr_t>(hdr->m_retAddr);
+                if (bcb != nullptr)
+                {
+                    uintptr_t fastPathStart = reinterpret_cast<uintptr_t>(bcb->m_jitRegionStart);
+                    uintptr_t slowPathStart = reinterpret_cast<uintptr_t>(bcb->m_jitSlowPathRegionStart);
+                    if (fastPathStart <= retAddr && retAddr < fastPathStart + bcb->m_jitRegionSize)
+                    {
+                        // The JIT fast path does not record the call site
+                        //
+                        isBaselineJit = true;
+                        hasLocation = false;
+                    }
+                    else if (slowPathStart <= retAddr && retAddr < slowPathStart + bcb->m_jitSlowPathRegionSize)
+                    {
+                        isBaselineJit = true;
+                    }
+                }
+            }
+        }
+        stackBase = callerStackBase;
+    }
+
+    auto it = m_stackCounts.find(m_stackBuffer);
+    if (it == m_stackCounts.end())
+    {
+        m_stackCounts[m_stackBuffer] = numTicks;
+    }
+    else
+    {
+        it->second += numTicks;
+    }
+    m_numSamples++;
+    m_numTicks += numTicks;
+}
+
+std::string WARN_UNUSED SamplingProfiler::GetFoldedStacks(bool withBytecodeOffset)
+{
+    std::unordered_map<uint64_t, std::string> functionNames;
+    auto getFunctionName = [&](uint64_t key) -> const std::string&
+    {
+        auto it = functionNames.find(key);
+        if (it != functionNames.end())
+        {
+            return it->second;
+        }
+        std::string name;
+        if (key == 1)
+        {
+            name = "[native function]";
+        }
+        else
+        {
+            name = reinterpret_cast<UnlinkedCodeBlock*>(key)->GetDebugName();
+            // ';' is the frame separator of the folded stack format
+            //
+            std::replace(name.begin(), name.end(), ';', '_');
+        }
+        return functionNames[key] = name;
+    };
+
+    // Different recorded stacks may have the same folded representation (e.g., if the bytecode offsets are not printed)
+    // Use an ordered map so that the output is deterministic
+    //
+    std::map<std::string, uint64_t> foldedStacks;
+    for (auto& it : m_stackCounts)
+    {
+        const std::vector<uint64_t>& stack = it.first;
+        assert(stack.size() % 2 == 0);
+        std::string folded;
+        for (size_t i = stack.size(); i > 0; i -= 2)
+        {
+            uint64_t func = stack[i - 2];
+            uint64_t info = stack[i - 1];
+            uint64_t bytecodeOffset = info >> 1;
+            bool isBaselineJit = (info & 1) != 0;
+            if (!folded.empty())
+            {
+                folded += ";";
+            }
+            folded += getFunctionName(func);
+            if (withBytecodeOffset && bytecodeOffset != x_unknownBytecodeOffset)
+            {
+                folded += "@" + std::to_string(bytecodeOffset);
+            }
+            if (isBaselineJit)
+            {
+                folded += "_[j]";
+            }
+        }
+        foldedStacks[folded] += it.second;
+    }
+
+    std::string result;
+    for (auto& it : foldedStacks)
+    {
+        result += it.first + " " + std::to_string(it.second) + "\n";
+    }
+    return result;
+}
+
+void SamplingProfiler::DumpFoldedStacks(FILE* file, bool withBytecodeOffset)
+{
+    std::string folded = GetFoldedStacks(withBytecodeOffset);
+    fwrite(folded.data(), 1, folded.length(), file);
+}
+
+extern "C" void NO_INLINE deegen_sampling_profiler_record_sample(void* stackBase, uint64_t isBaselineJit, void* location)
+{
+    VM* vm = VM::GetActiveVMForCurrentThread();
+    uint32_t numTicks = vm->TakeSamplingProfilerPendingTicks();
+    SamplingProfiler* profiler = vm->GetSamplingProfiler();
+    if (numTicks == 0 || profiler == nullptr || !profiler->IsRunning())
+    {
+        return;
+    }
+    profiler->RecordSample(stackBase, isBaselineJit != 0, location, numTicks);
+}
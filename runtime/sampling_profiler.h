@@ -0,0 +1,108 @@
+#pragma once
+
+#include "common.h"
+
+class VM;
+class CodeBlock;
+
+// A sampling profiler that records the guest language (Lua) call stacks, and dumps them in the folded stack format
+// (one line per distinct stack, 'root;caller;callee <count>'), which can be fed directly into flamegraph.pl.
+//
+// A SIGPROF timer (ITIMER_PROF, so it counts CPU time consumed by the process) fires at the requested rate.
+// The signal handler does nothing but increment VM::m_samplingProfilerPendingTicks. The stack is walked at the next
+// safepoint instead, since at an arbitrary machine instruction the stack frame of the running function may be half-built.
+// The safepoints are the function entries and the loop back-edges of both the interpreter and the baseline JIT
+// (see x_enable_sampling_profiler_safepoints), where the running code only checks if the pending tick count is nonzero.
+// So the profiler costs almost nothing when no tick is pending, and a stack walk (a few microseconds) per tick otherwise.
+//
+// Each recorded stack is weighted by the number of ticks pending when it is recorded, so the total weight reflects
+// the CPU time of the program. However, the time spent in a long-running library function (which has no safepoint)
+// is attributed to whatever Lua function reaches a safepoint next, typically its caller after the library function returns.
+//
+// For each frame, we record the function, the tier it is executing in, and the bytecode offset being executed
+// (for the innermost frame, this is the safepoint; for the other frames, this is the call site). The bytecode offset
+// is unknown (and not recorded) for a caller in the baseline JIT if the call was made from the JIT fast path, since
+// the fast path does not store its position in the stack frame. Since the parser does not keep the line number of
+// each bytecode, the source location is reported as '<chunk name>:<line of the function definition>'.
+//
+// Only the stack of the currently running coroutine is recorded.
+//
+// The safepoints are only emitted if x_enable_sampling_profiler_safepoints is true (off by default).
+// Otherwise, Start always fails.
+//
+class SamplingProfiler
+{
+public:
+    MAKE_NONCOPYABLE(SamplingProfiler);
+    MAKE_NONMOVABLE(SamplingProfiler);
+
+    SamplingProfiler(VM* vm)
+        : m_vm(vm)
+        , m_isRunning(false)
+        , m_numSamples(0)
+        , m_numTicks(0)
+    { }
+
+    ~SamplingProfiler();
+
+    // Start the SIGPROF timer. Only one profiler may be running in the process at any time.
+    // Returns false if the timer cannot be set up.
+    //
+    bool WARN_UNUSED Start(uint32_t samplesPerSecond);
+
+    // Stop the SIGPROF timer. The recorded samples are kept.
+    //
+    void Stop();
+
+    bool IsRunning() { return m_isRunning; }
+
+    // Record the stack at a safepoint. 'stackBase' is the stack frame of the innermost function, 'isBaselineJit' is its tier,
+    // and 'location' is the bytecode pointer (interpreter) or the SlowPathData pointer (baseline JIT) of the safepoint,
+    // or nullptr if the safepoint is the function entry.
+    //
+    void RecordSample(void* stackBase, bool isBaselineJit, void* location, uint64_t numTicks);
+
+    // Write the recorded stacks in the folded stack format.
+    // Frames executing in the baseline JIT are suffixed with '_[j]', the flamegraph.pl annotation for JIT'ed code.
+    // If 'withBytecodeOffset' is true, the name of each frame also contains the bytecode offset, so the flame graph
+    // shows which part of a function is hot, at the cost of splitting each function into many frames.
+    //
+    void DumpFoldedStacks(FILE* file, bool withBytecodeOffset);
+    std::string WARN_UNUSED GetFoldedStacks(bool withBytecodeOffset);
+
+    // The number of stacks recorded, and the total number of ticks they represent
+    //
+    uint64_t GetNumSamples() { return m_numSamples; }
+    uint64_t GetNumTicks() { return m_numTicks; }
+
+    void ClearSamples();
+
+    // Each frame is encoded as two words: the function (the UnlinkedCodeBlock* for a Lua function, or 1 for a library function),
+    // and the bytecode offset (or x_unknownBytecodeOffset) shifted left by one, with the lowest bit set if the frame is executing
+    // in the baseline JIT.
+    // The frames are ordered from the innermost function to the root.
+    //
+    static constexpr uint64_t x_unknownBytecodeOffset = static_cast<uint32_t>(-1);
+    static constexpr size_t x_maxStackDepth = 256;
+
+private:
+    struct StackHasher
+    {
+        size_t operator()(const std::vector<uint64_t>& stack) const;
+    };
+
+    static uint64_t WARN_UNUSED GetBytecodeOffsetForInterpreterLocation(CodeBlock* cb, uint32_t bytecodePtr32);
+    static uint64_t WARN_UNUSED GetBytecodeOffsetForBaselineJitLocation(CodeBlock* cb, uint32_t slowPathDataPtr32);
+
+    VM* m_vm;
+    bool m_isRunning;
+    uint64_t m_numSamples;
+    uint64_t m_numTicks;
+    std::vector<uint64_t> m_stackBuffer;
+    std::unordered_map<std::vector<uint64_t>, uint64_t, StackHasher> m_stackCounts;
+};
+
+// Called by the interpreter and baseline JIT code at a safepoint if VM::m_samplingProfilerPendingTicks is nonzero.
+// 'isBaselineJit' and 'location' are as in SamplingProfiler::RecordSample.
+//
+extern "C" void NO_INLINE deegen_sampling_profiler_record_sample(void* stackBase, uint64_t isBaselineJit, void* location);
@@ -810,6 +810,76 @@ public:
         return newTable;
     }
 
+    // Return the number of outgoing transitions of this node
+    //
+    uint32_t WARN_UNUSED GetNumTransitions(VM* vm)
+    {
+        if (m_transitionTable.IsNullPtr())
+        {
+            return 0;
+        }
+        else if (m_transitionTable.IsType<Structure>())
+        {
+            return 1;
+        }
+        else
+        {
+            assert(m_transitionTable.IsType<StructureTransitionTable>());
+            return TranslateToRawPointer(vm, m_transitionTable.As<StructureTransitionTable>())->m_numElementsInHashTable;
+        }
+    }
+
+    void UpdateStatsForNewTransition(VM* vm)
+    {
+        VM::StructureStats& stats = vm->GetStructureStats();
+        stats.m_numTransitionsCreated++;
+        stats.m_maxTransitionFanOut = std::max(stats.m_maxTransitionFanOut, GetNumTransitions(vm));
+    }
+
+    // Return true if the transition key exists in the transition table
+    //
+    bool WARN_UNUSED HasTransition(VM* vm, int32_t transitionKey)
+    {
+        if (m_transitionTable.IsNullPtr())
+        {
+            return false;
+        }
+        else if (m_transitionTable.IsType<Structure>())
+        {
+            return GetParentEdgeTransitionKey(m_transitionTable.As<Structure>()) == transitionKey;
+        }
+        else
+        {
+            assert(m_transitionTable.IsType<StructureTransitionTable>());
+            StructureTransitionTable* table = TranslateToRawPointer(vm, m_transitionTable.As<StructureTransitionTable>());
+            bool found;
+            std::ignore = StructureTransitionTable::Find(table, transitionKey, found /*out*/);
+            return found;
+        }
+    }
+
+    // Code that builds objects with data-dependent keys (or data-dependent key orders) creates an unbounded number of Structures,
+    // which pollutes every IC that sees these objects and grows the system heap without bound (we never prune the transition tree).
+    //
+    // So before adding a new AddProperty transition, we check the number of outgoing transitions of this node. If it already
+    // fans out too much, the object transitions to CacheableDictionary instead. Nodes with no property (e.g., the initial
+    // Structures) are exempt, since they are the common ancestor of all objects and their fan-out is simply the number of
+    // distinct first property names in the program.
+    //
+    // Only the node being transitioned from is considered: a well-behaved object shape that merely shares an ancestor
+    // with an exploding sibling subtree must keep getting Structures, otherwise its ICs would be needlessly defeated.
+    //
+    static constexpr uint32_t x_transitionFanOutGuardThreshold = 128;
+
+    bool WARN_UNUSED ShouldTransitionToDictionaryDueToFanOut(VM* vm)
+    {
+        if (m_numSlots == 0)
+        {
+            return false;
+        }
+        return GetNumTransitions(vm) >= x_transitionFanOutGuardThreshold;
+    }
+
     template<bool isInsert, typename Func>
     Structure* WARN_UNUSED ALWAYS_INLINE QueryTransitionTableAndInsertOrUpsertImpl(VM* vm, int32_t transitionKey, const Func& insertOrUpsertStructureFunc)
     {
@@ -829,6 +899,7 @@ public:
         {
             Structure* newStructure = getNewStructureForNotFoundCase();
             m_transitionTable.Store(SystemHeapPointer<Structure>(newStructure));
+            UpdateStatsForNewTransition(vm);
             return newStructure;
         }
         else if (likely(m_transitionTable.IsType<Structure>()))
@@ -872,6 +943,7 @@ public:
                 assert(m_transitionTable.IsType<StructureTransitionTable>() &&
                        TranslateToRawPointer(vm, m_transitionTable.As<StructureTransitionTable>()) == newTable);
 
+                UpdateStatsForNewTransition(vm);
                 return newStructure;
             }
         }
@@ -896,6 +968,7 @@ public:
                     // FIXME: delete old table!
                 }
 
+                UpdateStatsForNewTransition(vm);
                 return newStructure;
             }
             else
@@ -2300,6 +2373,8 @@ end_setup:
     }
 #endif
 
+    vm->GetStructureStats().m_numStructuresCreated++;
+
     return r;
 }
 
@@ -2344,6 +2419,8 @@ inline Structure* WARN_UNUSED Structure::CreateInitialStructure(VM* vm, uint8_t
     r->m_metatable = 0;
     r->m_transitionTable.m_value = 0;
 
+    vm->GetStructureStats().m_numStructuresCreated++;
+
     return r;
 }
 
@@ -2371,6 +2448,15 @@ inline void Structure::AddNonExistentProperty(VM* vm, UserHeapPointer<void> key,
     int32_t transitionKey = GeneralHeapPointer<void>(key.As()).m_value;
     assert(transitionKey < 0);
 
+    // Existing transitions are always taken, but do not create new ones if the transition tree is exploding
+    //
+    if (unlikely(!HasTransition(vm, transitionKey) && ShouldTransitionToDictionaryDueToFanOut(vm)))
+    {
+        vm->GetStructureStats().m_numDictionaryConversionsDueToFanOut++;
+        result.m_shouldTransitionToDictionaryMode = true;
+        return;
+    }
+
     // Get the structure after transition, creating it and insert it into transition table if needed
     //
     Structure* transitionStructure = QueryTransitionTableAndInsert(vm, transitionKey, [&]() -> Structure* {
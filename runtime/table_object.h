@@ -38,6 +38,7 @@ public:
         r->m_hiddenClass = ArraySparseMap::x_hiddenClassForArraySparseMap;
         r->m_hashMask = 1;
         r->m_elementCount = 0;
+        r->m_borderHint = 0;
         r->m_hashTable = new HashTableEntry[2];
         r->m_hashTable[0].m_key = std::numeric_limits<double>::quiet_NaN();
         r->m_hashTable[1].m_key = std::numeric_limits<double>::quiet_NaN();
@@ -53,6 +54,7 @@ public:
         r->m_hiddenClass = ArraySparseMap::x_hiddenClassForArraySparseMap;
         r->m_hashMask = m_hashMask;
         r->m_elementCount = m_elementCount;
+        r->m_borderHint = m_borderHint;
         r->m_hashTable = new HashTableEntry[m_hashMask + 1];
         memcpy(r->m_hashTable, m_hashTable, sizeof(HashTableEntry) * (m_hashMask + 1));
         return r;
@@ -182,6 +184,10 @@ public:
 
     uint32_t m_hashMask;
     uint32_t m_elementCount;
+    // A hint of the last known border of the array (see GetTableLengthWithLuaSemanticsSlowPath)
+    // Once the sparse map exists, the ButterflyHeader no longer has room for the hint, so it is stored here instead
+    //
+    uint32_t m_borderHint;
     HashTableEntry* m_hashTable;
 };
 
@@ -217,6 +223,34 @@ struct GetByIdICInfo
     int32_t m_slot;
 };
 
+// Describes how to find a property through the '__index' table of the metatable, for a GetById that misses in the object itself.
+// This is the common OOP pattern where methods live in a class table used as '__index'.
+//
+// The cached result stays valid as long as all of the following holds:
+// (1) The object's hidden class is unchanged, so the object still misses and still has the same metatable.
+//     This is guaranteed by the IC key.
+// (2) The metatable's hidden class is unchanged, so '__index' is still at the same slot, and that slot still holds the same table.
+// (3) The '__index' table's hidden class is unchanged, so the property is still at the same slot.
+//
+// (2) and (3) are checked by GetByIdFromIndexTableWithGuards. Note that both hit results on a Structure and on a CacheableDictionary
+// are cacheable by hidden class, so the metatable and the '__index' table may be in either mode.
+//
+struct GetByIdIndexTableICInfo
+{
+    TValue m_metatable;
+    TValue m_indexTable;
+    SystemHeapPointer<void> m_metatableHiddenClass;
+    SystemHeapPointer<void> m_indexTableHiddenClass;
+    // Where '__index' is in the metatable, must be InlinedStorage or OutlinedStorage
+    //
+    GetByIdICInfo::ICKind m_metatableIndexSlotKind;
+    int32_t m_metatableIndexSlot;
+    // Where the property is in the '__index' table, must be InlinedStorage or OutlinedStorage
+    //
+    GetByIdICInfo::ICKind m_propertySlotKind;
+    int32_t m_propertySlot;
+};
+
 struct GetByIntegerIndexICInfo
 {
     enum class ICKind: uint8_t
@@ -339,6 +373,81 @@ struct PutByIntegerIndexICInfo
     SystemHeapPointer<void> m_newHiddenClass;
 };
 
+// A VM-wide direct-mapped cache of <Structure, property name> => GetById/PutById lookup result.
+//
+// A GetById/PutById IC site that has seen more than x_maxJitGenericInlineCacheEntries hidden classes stops
+// creating IC entries, so every subsequent miss runs the IC body, which does a full hash lookup in the Structure.
+// Sites like generic serialization helpers can see hundreds of different shapes, so we want the lookup result
+// to be shared across all IC sites, similar to JavaScriptCore's megamorphic cache.
+//
+// No invalidation is needed for correctness right now: a Structure is immutable (adding a property always
+// transitions to another Structure), and the transition taken from a Structure by a given key is deterministic.
+// Dictionaries are mutable and 1-on-1 with the object, so they are never put into this cache.
+//
+// TODO: once GC is implemented, the cache must be cleared whenever a Structure may be collected.
+//
+class MegamorphicPropertyCache
+{
+    MAKE_NONCOPYABLE(MegamorphicPropertyCache);
+    MAKE_NONMOVABLE(MegamorphicPropertyCache);
+
+public:
+    MegamorphicPropertyCache() { Clear(); }
+
+    static constexpr uint32_t x_numEntriesLog2 = 11;
+    static constexpr uint32_t x_numEntries = 1U << x_numEntriesLog2;
+
+    struct GetByIdEntry
+    {
+        // 0 if the entry is empty
+        //
+        uint32_t m_hiddenClass;
+        int64_t m_propertyName;
+        GetByIdICInfo m_info;
+    };
+
+    struct PutByIdEntry
+    {
+        // 0 if the entry is empty
+        //
+        uint32_t m_hiddenClass;
+        int64_t m_propertyName;
+        PutByIdICInfo m_info;
+    };
+
+    static uint32_t WARN_UNUSED ALWAYS_INLINE ComputeSlot(uint32_t hiddenClass, int64_t propertyName)
+    {
+        // Both values are 8-byte aligned, so the low bits carry no information. Use multiplicative hashing and take the high bits.
+        //
+        uint32_t h = (hiddenClass >> 3) ^ (BitwiseTruncateTo<uint32_t>(static_cast<uint64_t>(propertyName) >> 3) * 0x9E3779B1U);
+        h *= 0x85EBCA6BU;
+        return h >> (32 - x_numEntriesLog2);
+    }
+
+    GetByIdEntry& WARN_UNUSED ALWAYS_INLINE GetByIdEntryFor(uint32_t hiddenClass, int64_t propertyName)
+    {
+        return m_getByIdEntries[ComputeSlot(hiddenClass, propertyName)];
+    }
+
+    PutByIdEntry& WARN_UNUSED ALWAYS_INLINE PutByIdEntryFor(uint32_t hiddenClass, int64_t propertyName)
+    {
+        return m_putByIdEntries[ComputeSlot(hiddenClass, propertyName)];
+    }
+
+    void Clear()
+    {
+        for (uint32_t i = 0; i < x_numEntries; i++)
+        {
+            m_getByIdEntries[i].m_hiddenClass = 0;
+            m_putByIdEntries[i].m_hiddenClass = 0;
+        }
+    }
+
+private:
+    GetByIdEntry m_getByIdEntries[x_numEntries];
+    PutByIdEntry m_putByIdEntries[x_numEntries];
+};
+
 class alignas(8) TableObject
 {
 public:
@@ -730,6 +839,136 @@ public:
         return PrepareGetByIdImplForCacheableDictionary(TCGet(self->m_hiddenClass), propertyName, icInfo /*out*/);
     }
 
+    // Same as PrepareGetById, except that if the hidden class is a Structure, the VM-wide MegamorphicPropertyCache is consulted first
+    // This should be used by the IC bodies, which is what runs on every execution once the IC site becomes megamorphic
+    //
+    template<typename T, typename U, typename = std::enable_if_t<IsPtrOrHeapPtr<T, TableObject>>>
+    static void PrepareGetByIdWithMegamorphicCache(T self, UserHeapPointer<U> propertyName, GetByIdICInfo& icInfo /*out*/)
+    {
+        SystemHeapPointer<void> hiddenClass = TCGet(self->m_hiddenClass);
+        if (likely(hiddenClass.As<SystemHeapGcObjectHeader>()->m_type == HeapEntityType::Structure))
+        {
+            MegamorphicPropertyCache::GetByIdEntry& entry = VM_GetMegamorphicPropertyCache()->GetByIdEntryFor(hiddenClass.m_value, propertyName.m_value);
+            if (likely(entry.m_hiddenClass == hiddenClass.m_value && entry.m_propertyName == propertyName.m_value))
+            {
+                icInfo = entry.m_info;
+                return;
+            }
+            PrepareGetByIdImplForStructure(hiddenClass, propertyName, icInfo /*out*/);
+            entry.m_hiddenClass = hiddenClass.m_value;
+            entry.m_propertyName = propertyName.m_value;
+            entry.m_info = icInfo;
+            return;
+        }
+        PrepareGetByIdImpl(hiddenClass, propertyName, icInfo /*out*/);
+    }
+
+    // Given that GetById on 'self' must return nil (ICKind::MustBeNil) but 'self' may have a metatable,
+    // check if the property can be found in the '__index' table of its metatable in a cacheable way.
+    // Return false if not, in which case 'icInfo' is not filled.
+    //
+    template<typename T, typename U, typename = std::enable_if_t<IsPtrOrHeapPtr<T, TableObject>>>
+    static bool WARN_UNUSED TryPrepareGetByIdFromIndexTable(T self, UserHeapPointer<U> propertyName, GetByIdIndexTableICInfo& icInfo /*out*/)
+    {
+        SystemHeapPointer<void> hiddenClass = TCGet(self->m_hiddenClass);
+        if (hiddenClass.As<SystemHeapGcObjectHeader>()->m_type != HeapEntityType::Structure)
+        {
+            return false;
+        }
+
+        // The metatable must be a constant of the object's structure, otherwise the IC key cannot guard it
+        //
+        HeapPtr<Structure> structure = hiddenClass.As<Structure>();
+        if (!Structure::HasMonomorphicMetatable(structure))
+        {
+            return false;
+        }
+        HeapPtr<TableObject> metatable = Structure::GetMonomorphicMetatable(structure);
+
+        UserHeapPointer<HeapString> indexMetamethodName = VM_GetStringNameForMetatableKind(LuaMetamethodKind::Index);
+        GetByIdICInfo mtInfo;
+        PrepareGetById(metatable, indexMetamethodName, mtInfo /*out*/);
+        if (mtInfo.m_icKind != GetByIdICInfo::ICKind::InlinedStorage && mtInfo.m_icKind != GetByIdICInfo::ICKind::OutlinedStorage)
+        {
+            return false;
+        }
+
+        TValue indexTable = GetById(metatable, indexMetamethodName.As<void>(), mtInfo);
+        if (!indexTable.Is<tTable>())
+        {
+            return false;
+        }
+
+        HeapPtr<TableObject> indexTableObj = indexTable.As<tTable>();
+        GetByIdICInfo propInfo;
+        PrepareGetById(indexTableObj, propertyName, propInfo /*out*/);
+        if (propInfo.m_icKind != GetByIdICInfo::ICKind::InlinedStorage && propInfo.m_icKind != GetByIdICInfo::ICKind::OutlinedStorage)
+        {
+            return false;
+        }
+
+        icInfo.m_metatable = TValue::Create<tTable>(metatable);
+        icInfo.m_indexTable = indexTable;
+        icInfo.m_metatableHiddenClass = TCGet(metatable->m_hiddenClass);
+        icInfo.m_indexTableHiddenClass = TCGet(indexTableObj->m_hiddenClass);
+        icInfo.m_metatableIndexSlotKind = mtInfo.m_icKind;
+        icInfo.m_metatableIndexSlot = mtInfo.m_slot;
+        icInfo.m_propertySlotKind = propInfo.m_icKind;
+        icInfo.m_propertySlot = propInfo.m_slot;
+        return true;
+    }
+
+    // Execute a GetById cached by GetByIdIndexTableICInfo.
+    // Returns nil if any of the guards fail (or if the property value is nil), in which case the caller must fall back to
+    // the generic metatable slow path, which handles every case correctly.
+    //
+    static TValue WARN_UNUSED ALWAYS_INLINE GetByIdFromIndexTableWithGuards(TValue metatable,
+                                                                           SystemHeapPointer<void> metatableHiddenClass,
+                                                                           GetByIdICInfo::ICKind metatableIndexSlotKind,
+                                                                           int32_t metatableIndexSlot,
+                                                                           TValue indexTable,
+                                                                           SystemHeapPointer<void> indexTableHiddenClass,
+                                                                           GetByIdICInfo::ICKind propertySlotKind,
+                                                                           int32_t propertySlot)
+    {
+        HeapPtr<TableObject> mt = metatable.As<tTable>();
+        if (unlikely(TCGet(mt->m_hiddenClass).m_value != metatableHiddenClass.m_value))
+        {
+            return TValue::Nil();
+        }
+
+        TValue curIndexTable;
+        if (metatableIndexSlotKind == GetByIdICInfo::ICKind::InlinedStorage)
+        {
+            curIndexTable = TCGet(mt->m_inlineStorage[metatableIndexSlot]);
+        }
+        else
+        {
+            assert(metatableIndexSlotKind == GetByIdICInfo::ICKind::OutlinedStorage);
+            curIndexTable = mt->m_butterfly->GetNamedProperty(metatableIndexSlot);
+        }
+        if (unlikely(curIndexTable.m_value != indexTable.m_value))
+        {
+            return TValue::Nil();
+        }
+
+        HeapPtr<TableObject> it = indexTable.As<tTable>();
+        if (unlikely(TCGet(it->m_hiddenClass).m_value != indexTableHiddenClass.m_value))
+        {
+            return TValue::Nil();
+        }
+
+        if (propertySlotKind == GetByIdICInfo::ICKind::InlinedStorage)
+        {
+            return TCGet(it->m_inlineStorage[propertySlot]);
+        }
+        else
+        {
+            assert(propertySlotKind == GetByIdICInfo::ICKind::OutlinedStorage);
+            return it->m_butterfly->GetNamedProperty(propertySlot);
+        }
+    }
+
     template<typename T, typename = std::enable_if_t<IsPtrOrHeapPtr<T, TableObject>>>
     static TValue WARN_UNUSED ALWAYS_INLINE GetById(T self, UserHeapPointer<void> /*propertyName*/, GetByIdICInfo icInfo)
     {
@@ -902,6 +1141,34 @@ public:
         }
     }
 
+    // Same as PreparePutById, except that if the hidden class is a Structure, the VM-wide MegamorphicPropertyCache is consulted first
+    //
+    template<typename T, typename U, typename = std::enable_if_t<IsPtrOrHeapPtr<T, TableObject>>>
+    static void PreparePutByIdWithMegamorphicCache(T self, UserHeapPointer<U> propertyName, PutByIdICInfo& icInfo /*out*/)
+    {
+        SystemHeapPointer<void> hiddenClass = TCGet(self->m_hiddenClass);
+        if (likely(hiddenClass.As<SystemHeapGcObjectHeader>()->m_type == HeapEntityType::Structure))
+        {
+            MegamorphicPropertyCache::PutByIdEntry& entry = VM_GetMegamorphicPropertyCache()->PutByIdEntryFor(hiddenClass.m_value, propertyName.m_value);
+            if (likely(entry.m_hiddenClass == hiddenClass.m_value && entry.m_propertyName == propertyName.m_value))
+            {
+                icInfo = entry.m_info;
+                return;
+            }
+            PreparePutByIdForStructure(hiddenClass.As<Structure>(), propertyName, icInfo /*out*/);
+            // The only uncacheable case is the transition to dictionary mode, which is rare enough that we don't bother
+            //
+            if (likely(icInfo.m_isInlineCacheable))
+            {
+                entry.m_hiddenClass = hiddenClass.m_value;
+                entry.m_propertyName = propertyName.m_value;
+                entry.m_info = icInfo;
+            }
+            return;
+        }
+        PreparePutById(self, propertyName, icInfo /*out*/);
+    }
+
     // Specialized PutById for global object
     // Global object is guaranteed to be a CacheableDictionary so we can remove a branch
     //
@@ -1161,6 +1428,7 @@ public:
         Structure* structure = TranslateToRawPointer(vm, m_hiddenClass.As<Structure>());
         CacheableDictionary::CreateFromStructure(vm, this, structure, prop, res /*out*/);
         CacheableDictionary* dictionary = res.m_dictionary;
+        vm->GetStructureStats().m_numDictionaryConversions++;
         if (res.m_shouldGrowButterfly)
         {
             GrowButterflyKnowingNamedStorageCapacity<true /*isGrowNamedStorage*/>(structure->m_butterflyNamedStorageCapacity, dictionary->m_butterflyNamedStorageCapacity);
@@ -1737,9 +2005,13 @@ public:
                     if (arrType.IsContinuous())
                     {
                         // We just turned from continuous to discontinuous
+                        // The old length is still a border (we either put a non-nil beyond 'length + 1' or a nil before 'length'),
+                        // so use it to seed the border hint
                         //
-                        assert(m_butterfly->GetHeader()->m_arrayLengthIfContinuous >= 0);
+                        int32_t oldLength = m_butterfly->GetHeader()->m_arrayLengthIfContinuous;
+                        assert(oldLength >= 0);
                         m_butterfly->GetHeader()->m_arrayLengthIfContinuous = -1;
+                        m_butterfly->GetHeader()->SetBorderHint(static_cast<uint32_t>(oldLength));
                     }
                 }
 
@@ -1802,9 +2074,28 @@ public:
                     if (!isContinuous)
                     {
                         // We just turned from continuous to discontinuous
+                        // The old length is still a border (we either put a non-nil beyond 'length + 1' or a nil before 'length'),
+                        // so use it to seed the border hint
                         //
-                        assert(m_butterfly->GetHeader()->m_arrayLengthIfContinuous >= 0);
+                        int32_t oldLength = m_butterfly->GetHeader()->m_arrayLengthIfContinuous;
+                        assert(oldLength >= 0);
                         m_butterfly->GetHeader()->m_arrayLengthIfContinuous = -1;
+                        m_butterfly->GetHeader()->SetBorderHint(static_cast<uint32_t>(oldLength));
+                    }
+                }
+                else if (!arrType.HasSparseMap())
+                {
+                    // Keep the border hint up-to-date for the common append ('t[#t+1] = v') and pop ('t[#t] = nil') patterns
+                    //
+                    ButterflyHeader* hdr = butterfly->GetHeader();
+                    uint32_t hint = hdr->GetBorderHint();
+                    if (!value.IsNil() && static_cast<uint32_t>(index) == hint + 1)
+                    {
+                        hdr->SetBorderHint(hint + 1);
+                    }
+                    else if (value.IsNil() && hint > 0 && static_cast<uint32_t>(index) == hint)
+                    {
+                        hdr->SetBorderHint(hint - 1);
                     }
                 }
 
@@ -1862,9 +2153,13 @@ public:
     ArraySparseMap* WARN_UNUSED AllocateNewArraySparseMap(VM* vm)
     {
         assert(m_butterfly != nullptr);
-        assert(!m_butterfly->GetHeader()->HasSparseMap());
+        ButterflyHeader* hdr = m_butterfly->GetHeader();
+        assert(!hdr->HasSparseMap());
         ArraySparseMap* sparseMap = ArraySparseMap::AllocateEmptyArraySparseMap(vm);
-        m_butterfly->GetHeader()->m_arrayLengthIfContinuous = GeneralHeapPointer<ArraySparseMap>(sparseMap).m_value;
+        // Inherit the border hint (or the exact length if the array is continuous), since the header is about to be overwritten
+        //
+        sparseMap->m_borderHint = hdr->IsContinuous() ? static_cast<uint32_t>(hdr->m_arrayLengthIfContinuous) : hdr->GetBorderHint();
+        hdr->m_arrayLengthIfContinuous = GeneralHeapPointer<ArraySparseMap>(sparseMap).m_value;
         return sparseMap;
     }
 
@@ -1943,6 +2238,20 @@ public:
         ArraySparseMap* sparseMap = GetOrAllocateSparseMap(vm);
         sparseMap->Insert(index, value);
 
+        // Keep the border hint up-to-date for the common append ('t[#t+1] = v') and pop ('t[#t] = nil') patterns
+        //
+        {
+            uint32_t hint = sparseMap->m_borderHint;
+            if (!value.IsNil() && UnsafeFloatEqual(index, static_cast<double>(hint) + 1))
+            {
+                sparseMap->m_borderHint = hint + 1;
+            }
+            else if (value.IsNil() && hint > 0 && UnsafeFloatEqual(index, static_cast<double>(hint)))
+            {
+                sparseMap->m_borderHint = hint - 1;
+            }
+        }
+
         if (arrType.m_asValue != newArrayType.m_asValue)
         {
             HeapEntityType ty = m_hiddenClass.As<SystemHeapGcObjectHeader>()->m_type;
@@ -2075,6 +2384,155 @@ public:
         }
     }
 
+    // Put 'numValues' values to consecutive integer indices starting at 'indexStart', as done by the table constructor
+    // in '{ ... }' or '{ a, b, f() }'. Since this is only used by table constructors, the table must have no metatable.
+    //
+    bool WARN_UNUSED NO_INLINE TryPutSequenceIntoVectorStorage(VM* vm, int32_t indexStart, const TValue* values, uint32_t numValues)
+    {
+        ArrayType arrType = m_arrayType;
+
+        // We only handle the case that the array part is empty, or is continuous and the sequence is appended right after its end.
+        // This covers all table constructors, since the sequence always comes after all the positional fields.
+        //
+        int64_t curLength;
+        if (arrType.ArrayKind() == ArrayType::Kind::NoButterflyArrayPart)
+        {
+            if (arrType.HasSparseMap())
+            {
+                return false;
+            }
+            curLength = 0;
+        }
+        else if (arrType.IsContinuous())
+        {
+            curLength = m_butterfly->GetHeader()->m_arrayLengthIfContinuous;
+        }
+        else
+        {
+            return false;
+        }
+        if (indexStart != curLength + ArrayGrowthPolicy::x_arrayBaseOrd)
+        {
+            return false;
+        }
+
+        // Figure out the continuity and the ArrayKind of the resulting array in one pass
+        //
+        uint32_t numLeadingNonNils = numValues;
+        uint32_t numValuesToCopy = 0;
+        ArrayType::Kind newKind = arrType.ArrayKind();
+        for (uint32_t i = 0; i < numValues; i++)
+        {
+            TValue value = values[i];
+            if (value.IsNil())
+            {
+                if (numLeadingNonNils == numValues)
+                {
+                    numLeadingNonNils = i;
+                }
+                continue;
+            }
+            numValuesToCopy = i + 1;
+            if (newKind == ArrayType::Kind::NoButterflyArrayPart)
+            {
+                newKind = value.IsInt32() ? ArrayType::Kind::Int32 : (value.IsDouble() ? ArrayType::Kind::Double : ArrayType::Kind::Any);
+            }
+            else if (newKind == ArrayType::Kind::Int32 && !value.IsInt32())
+            {
+                newKind = ArrayType::Kind::Any;
+            }
+            else if (newKind == ArrayType::Kind::Double && !value.IsDouble())
+            {
+                newKind = ArrayType::Kind::Any;
+            }
+        }
+
+        // Writing nils past the end of a continuous array (or into an empty array part) is a no-op
+        //
+        if (numValuesToCopy == 0)
+        {
+            return true;
+        }
+
+        // Trailing nils do not break continuity
+        //
+        bool isContinuous = (numLeadingNonNils >= numValuesToCopy);
+        int64_t lastIndex = static_cast<int64_t>(indexStart) + numValuesToCopy - 1;
+
+        // Follow the array growth policy: a continuous array can always use the vector storage, but a non-continuous array
+        // must go through the density check when it grows beyond x_alwaysVectorCutoff, which we leave to the slow path
+        //
+        if (lastIndex > (isContinuous ? ArrayGrowthPolicy::x_unconditionallySparseMapCutoff : ArrayGrowthPolicy::x_alwaysVectorCutoff))
+        {
+            return false;
+        }
+
+        uint32_t neededCapacity = static_cast<uint32_t>(lastIndex + 1 - ArrayGrowthPolicy::x_arrayBaseOrd);
+        if (m_butterfly == nullptr || m_butterfly->GetHeader()->m_arrayStorageCapacity < neededCapacity)
+        {
+            GrowButterfly<false /*isGrowNamedStorage*/>(std::max(neededCapacity, ArrayGrowthPolicy::x_initialVectorPartCapacity));
+        }
+
+        // Everything after the end of the continuous array is nil, so we only need to copy up to the last non-nil value
+        //
+        memcpy(m_butterfly->UnsafeGetInVectorIndexAddr(indexStart), values, sizeof(TValue) * numValuesToCopy);
+
+        ButterflyHeader* hdr = m_butterfly->GetHeader();
+        if (isContinuous)
+        {
+            hdr->m_arrayLengthIfContinuous = static_cast<int32_t>(lastIndex + 1 - ArrayGrowthPolicy::x_arrayBaseOrd);
+        }
+        else
+        {
+            hdr->m_arrayLengthIfContinuous = -1;
+            hdr->SetBorderHint(static_cast<uint32_t>(curLength + numLeadingNonNils));
+        }
+
+        ArrayType newArrayType = arrType;
+        newArrayType.SetIsContinuous(isContinuous);
+        newArrayType.SetArrayKind(newKind);
+
+        // If the new array type is different from the old array type, we need to update m_arrayType and m_hiddenClass
+        //
+        if (arrType.m_asValue != newArrayType.m_asValue)
+        {
+            HeapEntityType hiddenClassType = m_hiddenClass.As<SystemHeapGcObjectHeader>()->m_type;
+            assert(hiddenClassType == HeapEntityType::Structure || hiddenClassType == HeapEntityType::CacheableDictionary || hiddenClassType == HeapEntityType::UncacheableDictionary);
+            if (hiddenClassType == HeapEntityType::Structure)
+            {
+                Structure* structure = TranslateToRawPointer(vm, m_hiddenClass.As<Structure>());
+                Structure* newStructure = structure->UpdateArrayType(vm, newArrayType);
+                m_hiddenClass = newStructure;
+                m_arrayType = newArrayType;
+            }
+            else
+            {
+                // For dictionary, just update m_arrayType
+                //
+                m_arrayType = newArrayType;
+            }
+        }
+        return true;
+    }
+
+    // Bulk version of RawPutByValIntegerIndex for 'numValues' consecutive integer indices starting at 'indexStart'
+    // When possible, this sizes the vector storage once, copies the values in bulk, and computes the new ArrayType in one pass
+    //
+    template<typename T, typename = std::enable_if_t<IsPtrOrHeapPtr<T, TableObject>>>
+    static void RawPutSequenceByIntegerIndex(T self, int32_t indexStart, const TValue* values, uint32_t numValues)
+    {
+        VM* vm = VM::GetActiveVMForCurrentThread();
+        TableObject* obj = TranslateToRawPointer(vm, self);
+        if (likely(obj->TryPutSequenceIntoVectorStorage(vm, indexStart, values, numValues)))
+        {
+            return;
+        }
+        for (uint32_t i = 0; i < numValues; i++)
+        {
+            RawPutByValIntegerIndex(self, static_cast<int64_t>(indexStart) + i, values[i]);
+        }
+    }
+
     static uint32_t ComputeObjectAllocationSize(uint8_t inlineCapacity)
     {
         constexpr size_t x_baseSize = offsetof_member_v<&TableObject::m_inlineStorage>;
@@ -2540,10 +2998,10 @@ public:
         return lb;
     }
 
-    static uint32_t WARN_UNUSED NO_INLINE GetTableLengthWithLuaSemanticsSlowPath(HeapPtr<TableObject> self)
+    // Compute the length from scratch by binary search on the vector part and the sparse map
+    //
+    static uint32_t WARN_UNUSED GetTableLengthWithLuaSemanticsWithoutHint(Butterfly* butterfly, ArraySparseMap* sparseMap)
     {
-        ArrayType arrType = TCGet(self->m_arrayType);
-        Butterfly* butterfly = self->m_butterfly;
         TValue* tv = reinterpret_cast<TValue*>(butterfly);
         uint32_t arrayStorageCap = butterfly->GetHeader()->m_arrayStorageCapacity;
         if (arrayStorageCap > 0)
@@ -2583,9 +3041,8 @@ public:
             // Case 3: the last slot 'cap' is not nil, we are not guaranteed to find an empty slot in vector range.
             // Try to find in sparse map
             //
-            if (unlikely(arrType.HasSparseMap()))
+            if (unlikely(sparseMap != nullptr))
             {
-                ArraySparseMap* sparseMap = TranslateToRawPointer(butterfly->GetHeader()->GetSparseMap());
                 return GetTableLengthWithLuaSemanticsSlowPathSlowPath(sparseMap, arrayStorageCap);
             }
             else
@@ -2599,13 +3056,12 @@ public:
         {
             // The array doesn't have vector part, now check the sparse map part
             //
-            if (likely(!arrType.HasSparseMap()))
+            if (likely(sparseMap == nullptr))
             {
                 // It doesn't have sparse map part either, so length is 0
                 //
                 return 0;
             }
-            ArraySparseMap* sparseMap = TranslateToRawPointer(butterfly->GetHeader()->GetSparseMap());
             TValue val = sparseMap->GetByVal(1);
             if (val.IsNil())
             {
@@ -2619,6 +3075,98 @@ public:
         }
     }
 
+    // Return true if 'border' is a valid length under Lua semantics,
+    // that is, ('border' is 0 or slot 'border' is non-nil) and slot 'border + 1' is nil
+    //
+    static bool WARN_UNUSED ALWAYS_INLINE IsTableBorderWithLuaSemantics(Butterfly* butterfly, ArraySparseMap* sparseMap, uint32_t border)
+    {
+        static_assert(ArrayGrowthPolicy::x_arrayBaseOrd == 1, "this function currently only works under lua semantics");
+        if (unlikely(border >= std::numeric_limits<uint32_t>::max() / 2))
+        {
+            return false;
+        }
+        TValue* tv = reinterpret_cast<TValue*>(butterfly);
+        uint32_t arrayStorageCap = butterfly->GetHeader()->m_arrayStorageCapacity;
+        // Note that the vector part is authoritative for indices within its capacity: the sparse map never holds such indices
+        //
+        auto getElement = [&](uint32_t idx) ALWAYS_INLINE -> TValue
+        {
+            assert(idx >= 1);
+            if (idx <= arrayStorageCap)
+            {
+                return tv[idx];
+            }
+            if (sparseMap == nullptr)
+            {
+                return TValue::Nil();
+            }
+            return sparseMap->GetByVal(idx);
+        };
+        if (border > 0 && getElement(border).IsNil())
+        {
+            return false;
+        }
+        return getElement(border + 1).IsNil();
+    }
+
+    // The array is not continuous, so its length is not readily available.
+    //
+    // We keep a hint of the last border we found (in the ButterflyHeader, or in the sparse map if it exists).
+    // Between two '#' operations the border usually moves by at most one (e.g., 't[#t+1] = v' or 't[#t] = nil'),
+    // so we probe the hint and its two neighbors in O(1) before falling back to the binary search.
+    // The hint is never trusted without validation, so put paths (notably the JIT'ed fast paths) are free to not maintain it.
+    //
+    static uint32_t WARN_UNUSED NO_INLINE GetTableLengthWithLuaSemanticsSlowPath(HeapPtr<TableObject> self)
+    {
+        ArrayType arrType = TCGet(self->m_arrayType);
+        Butterfly* butterfly = self->m_butterfly;
+        ButterflyHeader* hdr = butterfly->GetHeader();
+        assert(!arrType.IsContinuous() && !hdr->IsContinuous());
+        AssertIff(arrType.HasSparseMap(), hdr->HasSparseMap());
+
+        ArraySparseMap* sparseMap = nullptr;
+        uint32_t hint;
+        if (unlikely(arrType.HasSparseMap()))
+        {
+            sparseMap = TranslateToRawPointer(hdr->GetSparseMap());
+            hint = sparseMap->m_borderHint;
+        }
+        else
+        {
+            hint = hdr->GetBorderHint();
+        }
+
+        if (likely(IsTableBorderWithLuaSemantics(butterfly, sparseMap, hint)))
+        {
+            return hint;
+        }
+
+        uint32_t result;
+        if (IsTableBorderWithLuaSemantics(butterfly, sparseMap, hint + 1))
+        {
+            result = hint + 1;
+        }
+        else if (hint > 0 && IsTableBorderWithLuaSemantics(butterfly, sparseMap, hint - 1))
+        {
+            result = hint - 1;
+        }
+        else
+        {
+            result = GetTableLengthWithLuaSemanticsWithoutHint(butterfly, sparseMap);
+        }
+        AssertImp(result < std::numeric_limits<uint32_t>::max() / 2, IsTableBorderWithLuaSemantics(butterfly, sparseMap, result));
+
+        if (sparseMap != nullptr)
+        {
+            sparseMap->m_borderHint = result;
+        }
+        else
+        {
+            hdr->SetBorderHint(result);
+        }
+        return result;
+    }
+
     // The 'length' operator under Lua semantics
     // The definition is any non-negative integer index n such that value for index 'n' is non-nil but value for index 'n+1' is nil,
     // or if index '1' is nil, the length is 0
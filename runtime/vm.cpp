@@ -1,6 +1,7 @@
 #include "vm.h"
 #include "runtime_utils.h"
 #include "deegen_options.h"
+#include "sampling_profiler.h"
 
 void InitializeDfgAllocationArenaIfNeeded();
 
@@ -116,6 +117,8 @@ bool WARN_UNUSED VM::InitializeVMBase()
 
     m_isEngineStartingTierBaselineJit = false;
     m_engineMaxTier = EngineMaxTier::Unrestricted;
+    m_interpreterTierUpPolicy = InterpreterTierUpPolicy::Default;
+    m_interpreterTierUpThresholdMultiplier = x_interpreter_tier_up_threshold_bytecode_length_multiplier;
 
     m_userHeapPtrLimit = -static_cast<int64_t>(x_vmBaseOffset - x_vmUserHeapSize);
     m_userHeapCurPtr = -static_cast<int64_t>(x_vmBaseOffset - x_vmUserHeapSize);
@@ -140,11 +143,201 @@ bool WARN_UNUSED VM::InitializeVMBase()
         m_spdsExecutionThreadFreeList[i] = SpdsPtr<void> { 0 };
     }
 
+    m_jitMemoryAllocator.SetUseTransparentHugePages(x_jit_use_transparent_huge_pages_for_hot_code);
+    m_jitDataMemoryAllocator.SetIsExecutable(false);
+    m_jitDataMemoryAllocator.SetIsWriteProtected(x_jit_write_protect_data_sections);
+
     m_totalBaselineJitCompilations = 0;
+    m_totalBaselineJitCompiledBytecodes = 0;
+    m_totalBaselineJitCompilationTimeNs = 0;
+    m_totalBaselineJitJettisons = 0;
+    m_jitCodeCacheSizeLimit = 0;
+    m_perfJitCodeMap = nullptr;
+    m_samplingProfiler = nullptr;
+    m_samplingProfilerPendingTicks = 0;
+    m_isBaselineJitWarmupCacheEnabled = false;
+    m_structureStats = StructureStats { };
+
+    return true;
+}
+
+void VM::SetInterpreterTierUpPolicy(InterpreterTierUpPolicy policy)
+{
+    m_interpreterTierUpPolicy = policy;
+    if (policy == InterpreterTierUpPolicy::Aggressive)
+    {
+        m_interpreterTierUpThresholdMultiplier = x_interpreter_tier_up_aggressive_threshold_bytecode_length_multiplier;
+    }
+    else if (policy == InterpreterTierUpPolicy::Conservative)
+    {
+        m_interpreterTierUpThresholdMultiplier = x_interpreter_tier_up_conservative_threshold_bytecode_length_multiplier;
+    }
+    else
+    {
+        // For the adaptive policy, start with the default multiplier until we have measured the baseline JIT
+        // For the custom policy, the user should call SetInterpreterTierUpThresholdMultiplier instead
+        //
+        ReleaseAssert(policy != InterpreterTierUpPolicy::Custom);
+        m_interpreterTierUpThresholdMultiplier = x_interpreter_tier_up_threshold_bytecode_length_multiplier;
+    }
+}
+
+size_t WARN_UNUSED VM::ComputeAdaptiveInterpreterTierUpThresholdMultiplier(uint64_t numBytecodes, uint64_t nanoseconds)
+{
+    if (numBytecodes == 0)
+    {
+        return x_interpreter_tier_up_threshold_bytecode_length_multiplier;
+    }
+    double nsPerBytecode = static_cast<double>(nanoseconds) / static_cast<double>(numBytecodes);
+    double multiplier = nsPerBytecode / x_interpreter_estimated_nanoseconds_per_bytecode;
+    multiplier = std::max(multiplier, static_cast<double>(x_interpreter_tier_up_aggressive_threshold_bytecode_length_multiplier));
+    multiplier = std::min(multiplier, static_cast<double>(x_interpreter_tier_up_conservative_threshold_bytecode_length_multiplier));
+    return static_cast<size_t>(multiplier + 0.5);
+}
+
+void VM::RecordBaselineJitCompilationTime(size_t numBytecodes, uint64_t nanoseconds)
+{
+    m_totalBaselineJitCompiledBytecodes += numBytecodes;
+    m_totalBaselineJitCompilationTimeNs += nanoseconds;
+
+    if (m_interpreterTierUpPolicy == InterpreterTierUpPolicy::Adaptive)
+    {
+        // The baseline JIT is so fast that the measurement of a single small function is mostly noise,
+        // so always use the aggregated speed of all compilations so far
+        //
+        assert(m_totalBaselineJitCompiledBytecodes > 0);
+        m_interpreterTierUpThresholdMultiplier = ComputeAdaptiveInterpreterTierUpThresholdMultiplier(m_totalBaselineJitCompiledBytecodes, m_totalBaselineJitCompilationTimeNs);
+    }
+}
+
+size_t WARN_UNUSED VM::GetInterpreterTierUpThresholdMultiplierForRecompilation(uint64_t numBytecodes, uint64_t nanoseconds)
+{
+    if (m_interpreterTierUpPolicy != InterpreterTierUpPolicy::Adaptive)
+    {
+        return m_interpreterTierUpThresholdMultiplier;
+    }
+    // A function that is unusually expensive to compile (e.g., it has many IC sites or huge bytecodes) should wait longer
+    // before it is compiled again, and vice versa. Since we have measured this very function, use its own compilation
+    // speed instead of the global average, except that it may not be cheaper than the global average by more than 2x,
+    // as the measurement of a small function is noisy.
+    //
+    size_t globalMultiplier = m_interpreterTierUpThresholdMultiplier;
+    size_t funcMultiplier = ComputeAdaptiveInterpreterTierUpThresholdMultiplier(numBytecodes, nanoseconds);
+    return std::max(funcMultiplier, globalMultiplier / 2);
+}
+
+bool WARN_UNUSED VM::EnablePerfJitCodeMap(bool alsoWriteJitDump)
+{
+    if (m_perfJitCodeMap != nullptr)
+    {
+        delete m_perfJitCodeMap;
+    }
+    m_perfJitCodeMap = JitCodePerfMapWriter::Create(alsoWriteJitDump);
+    return m_perfJitCodeMap != nullptr;
+}
+
+bool WARN_UNUSED VM::StartSamplingProfiler(uint32_t samplesPerSecond)
+{
+    if (m_samplingProfiler == nullptr)
+    {
+        m_samplingProfiler = new SamplingProfiler(this);
+    }
+    return m_samplingProfiler->Start(samplesPerSecond);
+}
+
+void VM::StopSamplingProfiler()
+{
+    if (m_samplingProfiler != nullptr)
+    {
+        m_samplingProfiler->Stop();
+    }
+}
+
+namespace {
+
+// The file format of the baseline JIT warm-up cache is simply a header followed by m_numKeys uint64_t keys
+//
+struct BaselineJitWarmupCacheFileHeader
+{
+    static constexpr uint64_t x_magic = 0x0031434a57524a4cULL;   // "LJRWJC1" in little-endian
+    // Reject corrupted files before trying to allocate memory for the keys
+    //
+    static constexpr uint64_t x_maxNumKeys = 1ULL << 24;
+
+    uint64_t m_magic;
+    uint64_t m_numKeys;
+};
+
+}   // anonymous namespace
+
+bool WARN_UNUSED VM::LoadBaselineJitWarmupCache(const char* fileName)
+{
+    m_isBaselineJitWarmupCacheEnabled = true;
+    m_baselineJitWarmupCacheLoadedKeys.clear();
 
+    FILE* fp = fopen(fileName, "rb");
+    if (fp == nullptr)
+    {
+        return false;
+    }
+    Auto(fclose(fp));
+
+    BaselineJitWarmupCacheFileHeader header;
+    if (fread(&header, sizeof(header), 1, fp) != 1 ||
+        header.m_magic != BaselineJitWarmupCacheFileHeader::x_magic ||
+        header.m_numKeys > BaselineJitWarmupCacheFileHeader::x_maxNumKeys)
+    {
+        return false;
+    }
+
+    std::vector<uint64_t> keys;
+    keys.resize(header.m_numKeys);
+    if (header.m_numKeys > 0 && fread(keys.data(), sizeof(uint64_t), keys.size(), fp) != keys.size())
+    {
+        return false;
+    }
+    m_baselineJitWarmupCacheLoadedKeys.insert(keys.begin(), keys.end());
     return true;
 }
 
+bool WARN_UNUSED VM::SaveBaselineJitWarmupCache(const char* fileName)
+{
+    ReleaseAssert(IsBaselineJitWarmupCacheEnabled());
+
+    // Write to a temporary file and rename it, so that a concurrently starting process never sees a partially written cache
+    //
+    std::string tmpFileName = std::string(fileName) + ".tmp" + std::to_string(getpid());
+    FILE* fp = fopen(tmpFileName.c_str(), "wb");
+    if (fp == nullptr)
+    {
+        return false;
+    }
+
+    std::vector<uint64_t> keys(m_baselineJitWarmupCacheCompiledKeys.begin(), m_baselineJitWarmupCacheCompiledKeys.end());
+    BaselineJitWarmupCacheFileHeader header {
+        .m_magic = BaselineJitWarmupCacheFileHeader::x_magic,
+        .m_numKeys = keys.size()
+    };
+    bool success = (fwrite(&header, sizeof(header), 1, fp) == 1);
+    if (success && keys.size() > 0)
+    {
+        success = (fwrite(keys.data(), sizeof(uint64_t), keys.size(), fp) == keys.size());
+    }
+    if (fclose(fp) != 0)
+    {
+        success = false;
+    }
+    if (success)
+    {
+        success = (rename(tmpFileName.c_str(), fileName) == 0);
+    }
+    if (!success)
+    {
+        std::ignore = unlink(tmpFileName.c_str());
+    }
+    return success;
+}
+
 void __attribute__((__preserve_most__)) VM::BumpUserHeap()
 {
     assert(m_userHeapCurPtr < m_userHeapPtrLimit);
@@ -322,10 +515,29 @@ bool WARN_UNUSED VM::InitializeVMGlobalData()
 
     m_usrPRNG = nullptr;
 
+    m_megamorphicPropertyCache = new (std::nothrow) MegamorphicPropertyCache();
+    CHECK_LOG_ERROR(m_megamorphicPropertyCache != nullptr, "Failed to allocate megamorphic property cache");
+
     CreateRootCoroutine();
     return true;
 }
 
+void VM::CleanupVMGlobalData()
+{
+    if (m_megamorphicPropertyCache != nullptr)
+    {
+        delete m_megamorphicPropertyCache;
+    }
+    if (m_perfJitCodeMap != nullptr)
+    {
+        delete m_perfJitCodeMap;
+    }
+    if (m_samplingProfiler != nullptr)
+    {
+        delete m_samplingProfiler;
+    }
+}
+
 bool WARN_UNUSED VM::InitializeVMStringManager()
 {
     static constexpr uint32_t x_initialSize = 1024;
@@ -401,6 +613,7 @@ bool WARN_UNUSED VM::Initialize()
 
 void VM::Cleanup()
 {
+    CleanupVMGlobalData();
     CleanupVMStringManager();
 }
 
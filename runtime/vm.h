@@ -4,6 +4,7 @@
 #include "tvalue.h"
 #include "array_type.h"
 #include "jit_memory_allocator.h"
+#include "jit_code_perf_map.h"
 
 enum ThreadKind : uint8_t
 {
@@ -498,6 +499,10 @@ public:
 static_assert(sizeof(HeapString) == 16);
 
 class ScriptModule;
+class MegamorphicPropertyCache;
+class CoroutineRuntimeContext;
+class BaselineCodeBlock;
+class SamplingProfiler;
 
 // [ 12GB user heap ] [ 2GB padding ] [ 2GB short-pointer data structures ] [ 2GB system heap ]
 //                                                                          ^
@@ -772,6 +777,9 @@ public:
         // A special object denoting that the 'is_next' validation of a key-value for-loop has passed
         //
         BaseNextValidationOk,
+        // A special object denoting that the 'is_ipairs_iter' validation of a key-value for-loop has passed
+        //
+        BaseIPairsIterValidationOk,
         // must be last member
         //
         X_END_OF_ENUM
@@ -848,6 +856,16 @@ public:
         return GetUserPRNGSlow();
     }
 
+    MegamorphicPropertyCache* GetMegamorphicPropertyCache()
+    {
+        return m_megamorphicPropertyCache;
+    }
+
+    static constexpr size_t OffsetofMegamorphicPropertyCache()
+    {
+        return offsetof_member_v<&VM::m_megamorphicPropertyCache>;
+    }
+
     static constexpr size_t OffsetofStringNameForMetatableKind()
     {
         return offsetof_member_v<&VM::m_stringNameForMetatableKind>;
@@ -917,14 +935,232 @@ public:
     //
     bool WARN_UNUSED BaselineJitCanTierUpFurther() { return false; }
 
+    // Determines how eagerly the interpreter tiers up a function to baseline JIT,
+    // see x_interpreter_tier_up_threshold_bytecode_length_multiplier and the options after it
+    //
+    enum class InterpreterTierUpPolicy : uint8_t
+    {
+        Default,
+        Aggressive,
+        Conservative,
+        // The multiplier is recomputed from the measured baseline JIT compilation speed.
+        // Only the JIT compile time is measured, the interpreter speed is a fixed estimate (x_interpreter_estimated_nanoseconds_per_bytecode)
+        //
+        Adaptive,
+        // The multiplier is explicitly specified by SetInterpreterTierUpThresholdMultiplier
+        //
+        Custom
+    };
+
+    // Only affects CodeBlocks created after this call.
+    //
+    void SetInterpreterTierUpPolicy(InterpreterTierUpPolicy policy);
+    InterpreterTierUpPolicy GetInterpreterTierUpPolicy() { return m_interpreterTierUpPolicy; }
+
+    // Only affects CodeBlocks created after this call. This also sets the policy to 'Custom'.
+    //
+    void SetInterpreterTierUpThresholdMultiplier(size_t multiplier)
+    {
+        m_interpreterTierUpPolicy = InterpreterTierUpPolicy::Custom;
+        m_interpreterTierUpThresholdMultiplier = multiplier;
+    }
+
+    // A newly-created CodeBlock tiers up to baseline JIT after executing this many times its bytecode length of bytecodes
+    //
+    size_t GetInterpreterTierUpThresholdMultiplier() { return m_interpreterTierUpThresholdMultiplier; }
+
+    // Called by the baseline JIT after each compilation, so that the adaptive tier-up policy knows how fast the baseline JIT is
+    //
+    void RecordBaselineJitCompilationTime(size_t numBytecodes, uint64_t nanoseconds);
+
+    // The multiplier chosen by the adaptive policy for a baseline JIT that compiles 'numBytecodes' bytecodes in 'nanoseconds'
+    //
+    static size_t WARN_UNUSED ComputeAdaptiveInterpreterTierUpThresholdMultiplier(uint64_t numBytecodes, uint64_t nanoseconds);
+
+    // The multiplier to use for a function whose baseline JIT code has been jettisoned, so it may tier up again.
+    // The function has been compiled once, taking 'nanoseconds' for 'numBytecodes' bytecodes.
+    // Under the adaptive policy, this is adjusted by the measured compilation speed of this function.
+    // Under the other policies, this is the same as GetInterpreterTierUpThresholdMultiplier().
+    //
+    size_t WARN_UNUSED GetInterpreterTierUpThresholdMultiplierForRecompilation(uint64_t numBytecodes, uint64_t nanoseconds);
+
+    uint64_t GetTotalBaselineJitCompiledBytecodes() { return m_totalBaselineJitCompiledBytecodes; }
+    uint64_t GetTotalBaselineJitCompilationTimeNs() { return m_totalBaselineJitCompilationTimeNs; }
+
+    // The allocator for hot JIT code: the fast path and data section of baseline JIT code, and the IC stubs
+    //
     JitMemoryAllocator* GetJITMemoryAlloc()
     {
         return &m_jitMemoryAllocator;
     }
 
+    // The allocator for cold JIT code: the slow path of baseline JIT code.
+    // Keeping the slow paths out of the way makes the hot code of different functions more densely packed.
+    //
+    JitMemoryAllocator* GetJITColdMemoryAlloc()
+    {
+        return &m_jitColdMemoryAllocator;
+    }
+
+    // The allocator for the data section of baseline JIT code. The memory is not executable, and if x_jit_write_protect_data_sections
+    // is true, it is write-protected once the codegen has finished writing it (see JitMemoryAllocator::SetIsWriteProtected).
+    //
+    JitMemoryAllocator* GetJITDataMemoryAlloc()
+    {
+        return &m_jitDataMemoryAllocator;
+    }
+
+    // The total size of JIT code and data in all the JIT memory allocators
+    //
+    size_t GetTotalJITCodeSize()
+    {
+        return m_jitMemoryAllocator.GetTotalJITCodeSize() + m_jitColdMemoryAllocator.GetTotalJITCodeSize() + m_jitDataMemoryAllocator.GetTotalJITCodeSize();
+    }
+
     uint32_t GetNumTotalBaselineJitCompilations() { return m_totalBaselineJitCompilations; }
     void IncrementNumTotalBaselineJitCompilations() { m_totalBaselineJitCompilations++; }
 
+    // The soft limit of the total size of JIT code (including IC stubs), in bytes. 0 means unlimited, which is the default.
+    //
+    // When the limit is exceeded, the next baseline JIT compilation first evicts the baseline JIT code of the functions that
+    // have not run recently, and the evicted functions go back to the interpreter (they may tier up again later).
+    //
+    void SetJitCodeCacheSizeLimit(size_t limitBytes) { m_jitCodeCacheSizeLimit = limitBytes; }
+    size_t GetJitCodeCacheSizeLimit() { return m_jitCodeCacheSizeLimit; }
+
+    // All the BaselineCodeBlocks that currently own JIT code, in the order they were compiled
+    //
+    std::vector<BaselineCodeBlock*>& GetLiveBaselineCodeBlocks() { return m_liveBaselineCodeBlocks; }
+
+    // The system heap does not support deallocation, so the BaselineCodeBlock of a function whose JIT code has been evicted
+    // is kept here, and reused by BaselineCodeBlock::Create when the function is compiled again.
+    //
+    void RecordJettisonedBaselineCodeBlock(CodeBlock* cb, BaselineCodeBlock* bcb)
+    {
+        assert(!m_jettisonedBaselineCodeBlocks.count(cb));
+        m_jettisonedBaselineCodeBlocks[cb] = bcb;
+    }
+
+    // Returns nullptr if 'cb' has no jettisoned BaselineCodeBlock
+    //
+    BaselineCodeBlock* WARN_UNUSED TakeJettisonedBaselineCodeBlock(CodeBlock* cb)
+    {
+        auto it = m_jettisonedBaselineCodeBlocks.find(cb);
+        if (likely(it == m_jettisonedBaselineCodeBlocks.end()))
+        {
+            return nullptr;
+        }
+        BaselineCodeBlock* bcb = it->second;
+        m_jettisonedBaselineCodeBlocks.erase(it);
+        return bcb;
+    }
+
+    // The coroutines that may still be alive, used to find out which JIT code is still referenced by a stack frame.
+    // Dead coroutines are lazily removed when a new coroutine is created and by the code cache eviction logic.
+    //
+    std::vector<CoroutineRuntimeContext*>& GetAllCoroutines() { return m_allCoroutines; }
+
+    // The number of times the baseline JIT code of a function was evicted from the code cache
+    //
+    uint32_t GetNumTotalBaselineJitJettisons() { return m_totalBaselineJitJettisons; }
+    void IncrementNumTotalBaselineJitJettisons() { m_totalBaselineJitJettisons++; }
+
+    // Let the Linux 'perf' tool symbolize the JIT code created after this call, see JitCodePerfMapWriter.
+    // If 'alsoWriteJitDump' is true, the code bytes are also written in the jitdump format.
+    // Returns false if the files cannot be created.
+    //
+    bool WARN_UNUSED EnablePerfJitCodeMap(bool alsoWriteJitDump);
+
+    // nullptr if the perf map is not enabled
+    //
+    JitCodePerfMapWriter* GetPerfJitCodeMap() { return m_perfJitCodeMap; }
+
+    // Start the sampling profiler (see SamplingProfiler) at the given rate, creating it if it does not exist yet.
+    // The samples accumulate across multiple Start/Stop pairs until SamplingProfiler::ClearSamples is called.
+    // Returns false if the profiler cannot be started (e.g., another VM in the process is being profiled).
+    //
+    bool WARN_UNUSED StartSamplingProfiler(uint32_t samplesPerSecond);
+    void StopSamplingProfiler();
+
+    // nullptr if the sampling profiler has never been started
+    //
+    SamplingProfiler* GetSamplingProfiler() { return m_samplingProfiler; }
+
+    // The number of SIGPROF ticks that have not been handled by a safepoint yet.
+    // Incremented by the signal handler, so it must be accessed atomically.
+    //
+    uint32_t* GetSamplingProfilerPendingTicksAddr() { return &m_samplingProfilerPendingTicks; }
+
+    uint32_t WARN_UNUSED TakeSamplingProfilerPendingTicks()
+    {
+        return __atomic_exchange_n(&m_samplingProfilerPendingTicks, 0U, __ATOMIC_RELAXED);
+    }
+
+    static uint32_t WARN_UNUSED ALWAYS_INLINE GetSamplingProfilerPendingTicksFromInterpreter()
+    {
+        constexpr size_t offset = offsetof_member_v<&VM::m_samplingProfilerPendingTicks>;
+        using T = typeof_member_t<&VM::m_samplingProfilerPendingTicks>;
+        // The counter is concurrently incremented by the signal handler, so the load must be atomic.
+        // Relaxed ordering is enough since the value is only used to decide whether to take the slow path.
+        //
+        return __atomic_load_n(reinterpret_cast<HeapPtr<T>>(offset), __ATOMIC_RELAXED);
+    }
+
+    // The baseline JIT warm-up cache remembers which functions got compiled by the baseline JIT across runs of the VM.
+    // A function is identified by a hash of its bytecode (see UnlinkedCodeBlock::ComputeBaselineJitWarmupCacheKey).
+    // When a CodeBlock is created for a function in the cache, it is compiled to baseline JIT code immediately,
+    // so a restarted process does not have to re-warm its hot functions in the interpreter.
+    //
+    // This enables the cache and loads the functions recorded by SaveBaselineJitWarmupCache in a previous run.
+    // Only affects CodeBlocks created after this call.
+    // Returns false if the file does not exist or is not a valid cache file, in which case the cache is enabled but starts empty.
+    //
+    bool WARN_UNUSED LoadBaselineJitWarmupCache(const char* fileName);
+
+    // Writes all the functions compiled by the baseline JIT since the cache was enabled (including the ones compiled
+    // because they were in the loaded cache) to 'fileName'. Returns false on failure.
+    //
+    bool WARN_UNUSED SaveBaselineJitWarmupCache(const char* fileName);
+
+    bool IsBaselineJitWarmupCacheEnabled() { return m_isBaselineJitWarmupCacheEnabled; }
+
+    bool WARN_UNUSED IsInLoadedBaselineJitWarmupCache(uint64_t key)
+    {
+        assert(IsBaselineJitWarmupCacheEnabled());
+        return m_baselineJitWarmupCacheLoadedKeys.count(key) > 0;
+    }
+
+    // Called by the baseline JIT after each compilation if the cache is enabled
+    //
+    void RecordBaselineJitWarmupCacheKey(uint64_t key)
+    {
+        assert(IsBaselineJitWarmupCacheEnabled());
+        m_baselineJitWarmupCacheCompiledKeys.insert(key);
+    }
+
+    // Statistics about the hidden class transition tree, exposed to user programs via 'debug.structurestats'
+    //
+    struct StructureStats
+    {
+        // The total number of Structures created
+        //
+        uint64_t m_numStructuresCreated;
+        // The total number of edges added to the Structure transition tree
+        //
+        uint64_t m_numTransitionsCreated;
+        // The maximum number of outgoing transitions ever observed on a single Structure
+        //
+        uint32_t m_maxTransitionFanOut;
+        // The total number of objects that transitioned from a Structure to a CacheableDictionary
+        //
+        uint64_t m_numDictionaryConversions;
+        // The number of dictionary conversions caused by the transition fan-out guard (see Structure::ShouldTransitionToDictionaryDueToFanOut)
+        //
+        uint64_t m_numDictionaryConversionsDueToFanOut;
+    };
+
+    StructureStats& GetStructureStats() { return m_structureStats; }
+
     static constexpr size_t x_pageSize = 4096;
 
 private:
@@ -1031,6 +1267,7 @@ private:
     bool WARN_UNUSED InitializeVMStringManager();
     void CleanupVMStringManager();
     bool WARN_UNUSED InitializeVMGlobalData();
+    void CleanupVMGlobalData();
     bool WARN_UNUSED Initialize();
     void Cleanup();
     void CreateRootCoroutine();
@@ -1044,6 +1281,8 @@ private:
 
     bool m_isEngineStartingTierBaselineJit;
     EngineMaxTier m_engineMaxTier;
+    InterpreterTierUpPolicy m_interpreterTierUpPolicy;
+    size_t m_interpreterTierUpThresholdMultiplier;
 
     alignas(64) SpdsAllocImpl<VM, false /*isTempAlloc*/> m_executionThreadSpdsAlloc;
 
@@ -1068,8 +1307,25 @@ private:
     SpdsPtr<void> m_spdsExecutionThreadFreeList[x_numSpdsAllocatableClassNotUsingLfFreelist];
 
     JitMemoryAllocator m_jitMemoryAllocator;
+    JitMemoryAllocator m_jitColdMemoryAllocator;
+    JitMemoryAllocator m_jitDataMemoryAllocator;
 
     uint32_t m_totalBaselineJitCompilations;
+    uint64_t m_totalBaselineJitCompiledBytecodes;
+    uint64_t m_totalBaselineJitCompilationTimeNs;
+    uint32_t m_totalBaselineJitJettisons;
+    size_t m_jitCodeCacheSizeLimit;
+    std::vector<BaselineCodeBlock*> m_liveBaselineCodeBlocks;
+    std::unordered_map<CodeBlock*, BaselineCodeBlock*> m_jettisonedBaselineCodeBlocks;
+    std::vector<CoroutineRuntimeContext*> m_allCoroutines;
+    JitCodePerfMapWriter* m_perfJitCodeMap;
+    SamplingProfiler* m_samplingProfiler;
+    uint32_t m_samplingProfilerPendingTicks;
+    bool m_isBaselineJitWarmupCacheEnabled;
+    std::unordered_set<uint64_t> m_baselineJitWarmupCacheLoadedKeys;
+    std::unordered_set<uint64_t> m_baselineJitWarmupCacheCompiledKeys;
+
+    StructureStats m_structureStats;
 
     alignas(64) std::mutex m_spdsAllocationMutex;
 
@@ -1107,6 +1363,10 @@ private:
     TValue m_vmLibFunctionObjects[static_cast<size_t>(LibFn::X_END_OF_ENUM)];
     SystemHeapPointer<ExecutableCode> m_vmLibFnProtos[static_cast<size_t>(LibFnProto::X_END_OF_ENUM)];
 
+    // The VM-wide cache used by megamorphic GetById/PutById IC sites, see comments on MegamorphicPropertyCache
+    //
+    MegamorphicPropertyCache* m_megamorphicPropertyCache;
+
     // The PRNG exposed to the user program. Internal VM logic must not use this PRNG.
     //
     std::mt19937* m_usrPRNG;
@@ -1158,6 +1418,12 @@ inline UserHeapPointer<HeapString> VM_GetStringNameForMetatableKind(LuaMetametho
     return TCGet(reinterpret_cast<HeapPtr<UserHeapPointer<HeapString>>>(offset)[static_cast<size_t>(kind)]);
 }
 
+inline MegamorphicPropertyCache* ALWAYS_INLINE VM_GetMegamorphicPropertyCache()
+{
+    constexpr size_t offset = VM::OffsetofMegamorphicPropertyCache();
+    return *reinterpret_cast<HeapPtr<MegamorphicPropertyCache*>>(offset);
+}
+
 template<VM::LibFn fn>
 inline TValue ALWAYS_INLINE VM_GetLibFunctionObject()
 {
@@ -19,7 +19,99 @@ static void PrintLJRVersion()
 static void PrintLJRUsage()
 {
     PrintLJRVersion();
-    fprintf(stderr, "\nusage: luajitr <script> [args]...\n");
+    fprintf(stderr, "\nusage: luajitr [options] <script> [args]...\n");
+    fprintf(stderr, "Available options are:\n");
+    fprintf(stderr, "  --tier-up-policy=<policy>  How eagerly functions tier up to baseline JIT:\n");
+    fprintf(stderr, "                             default, aggressive, conservative or adaptive\n");
+    fprintf(stderr, "  --tier-up-multiplier=<n>   Tier up to baseline JIT after executing n times the function's bytecode length\n");
+    fprintf(stderr, "  --jit-code-cache-limit=<n> Evict JIT code not run recently once it exceeds n bytes\n");
+    fprintf(stderr, "  --perf-map                 Write /tmp/perf-<pid>.map so that the Linux perf tool can symbolize JIT code\n");
+    fprintf(stderr, "  --perf-jitdump             Same as --perf-map, and also write the JIT code to /tmp/jit-<pid>.dump\n");
+    fprintf(stderr, "                             for 'perf inject --jit' (record with 'perf record -k 1')\n");
+    fprintf(stderr, "  --jit-warmup-cache=<file>  Immediately JIT the functions that got JIT'ed in previous runs recorded in file,\n");
+    fprintf(stderr, "                             and record the functions JIT'ed in this run into file on exit\n");
+}
+
+// Returns false if 'opt' is not a valid option
+// 'warmupCacheFile' is set if the baseline JIT warm-up cache should be saved to a file after the script finishes
+//
+static bool WARN_UNUSED ProcessOption(VM* vm, const char* opt, const char*& warmupCacheFile /*out*/)
+{
+    constexpr const char* x_tierUpPolicyPrefix = "--tier-up-policy=";
+    constexpr const char* x_tierUpMultiplierPrefix = "--tier-up-multiplier=";
+    constexpr const char* x_jitCodeCacheLimitPrefix = "--jit-code-cache-limit=";
+    constexpr const char* x_jitWarmupCachePrefix = "--jit-warmup-cache=";
+    if (strncmp(opt, x_tierUpPolicyPrefix, strlen(x_tierUpPolicyPrefix)) == 0)
+    {
+        const char* policy = opt + strlen(x_tierUpPolicyPrefix);
+        if (strcmp(policy, "default") == 0)
+        {
+            vm->SetInterpreterTierUpPolicy(VM::InterpreterTierUpPolicy::Default);
+        }
+        else if (strcmp(policy, "aggressive") == 0)
+        {
+            vm->SetInterpreterTierUpPolicy(VM::InterpreterTierUpPolicy::Aggressive);
+        }
+        else if (strcmp(policy, "conservative") == 0)
+        {
+            vm->SetInterpreterTierUpPolicy(VM::InterpreterTierUpPolicy::Conservative);
+        }
+        else if (strcmp(policy, "adaptive") == 0)
+        {
+            vm->SetInterpreterTierUpPolicy(VM::InterpreterTierUpPolicy::Adaptive);
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+    if (strncmp(opt, x_tierUpMultiplierPrefix, strlen(x_tierUpMultiplierPrefix)) == 0)
+    {
+        const char* value = opt + strlen(x_tierUpMultiplierPrefix);
+        char* end = nullptr;
+        unsigned long long multiplier = strtoull(value, &end, 10 /*base*/);
+        if (*value == '\0' || *end != '\0')
+        {
+            return false;
+        }
+        vm->SetInterpreterTierUpThresholdMultiplier(static_cast<size_t>(multiplier));
+        return true;
+    }
+    if (strncmp(opt, x_jitCodeCacheLimitPrefix, strlen(x_jitCodeCacheLimitPrefix)) == 0)
+    {
+        const char* value = opt + strlen(x_jitCodeCacheLimitPrefix);
+        char* end = nullptr;
+        unsigned long long limit = strtoull(value, &end, 10 /*base*/);
+        if (*value == '\0' || *end != '\0')
+        {
+            return false;
+        }
+        vm->SetJitCodeCacheSizeLimit(static_cast<size_t>(limit));
+        return true;
+    }
+    if (strcmp(opt, "--perf-map") == 0 || strcmp(opt, "--perf-jitdump") == 0)
+    {
+        if (!vm->EnablePerfJitCodeMap(strcmp(opt, "--perf-jitdump") == 0 /*alsoWriteJitDump*/))
+        {
+            fprintf(stderr, "Warning: failed to create the perf map files, JIT code will not be symbolized\n");
+        }
+        return true;
+    }
+    if (strncmp(opt, x_jitWarmupCachePrefix, strlen(x_jitWarmupCachePrefix)) == 0)
+    {
+        const char* fileName = opt + strlen(x_jitWarmupCachePrefix);
+        if (*fileName == '\0')
+        {
+            return false;
+        }
+        // It is normal that the file does not exist yet on the first run
+        //
+        std::ignore = vm->LoadBaselineJitWarmupCache(fileName);
+        warmupCacheFile = fileName;
+        return true;
+    }
+    return false;
 }
 
 static void LaunchScript(int argc, char** argv)
@@ -27,18 +119,34 @@ static void LaunchScript(int argc, char** argv)
     assert(argc >= 2);
     VM* vm = VM::Create();
 
+    const char* warmupCacheFile = nullptr;
+    int scriptArgIdx = 1;
+    while (scriptArgIdx < argc && strncmp(argv[scriptArgIdx], "--", 2) == 0)
+    {
+        if (!ProcessOption(vm, argv[scriptArgIdx], warmupCacheFile /*out*/))
+        {
+            fprintf(stderr, "Unrecognized option '%s'\n\n", argv[scriptArgIdx]);
+            PrintLJRUsage();
+            exit(1);
+        }
+        scriptArgIdx++;
+    }
+    if (scriptArgIdx >= argc)
+    {
+        PrintLJRUsage();
+        exit(1);
+    }
+
     // According to Lua Standard:
     //     Before starting to run the script, lua collects all arguments in the command line in a global table called arg.
     //     The script name is stored at index 0, the first argument after the script name goes to index 1, and so on.
     //     Any arguments before the script name (that is, the interpreter name plus the options) go to negative indices.
     //
     HeapPtr<TableObject> arg = TableObject::CreateEmptyTableObject(vm, 0U /*inlineCapacity*/, static_cast<uint32_t>(argc) /*arrayCapacity*/);
-    // TODO: this needs to be changed when we support options
-    //
     for (int i = 0; i < argc; i++)
     {
         TValue opt = TValue::Create<tString>(vm->CreateStringObjectFromRawCString(argv[i]));
-        TableObject::RawPutByValIntegerIndex(arg, i - 1 /*index*/, opt);
+        TableObject::RawPutByValIntegerIndex(arg, i - scriptArgIdx /*index*/, opt);
     }
 
     {
@@ -49,7 +157,7 @@ static void LaunchScript(int argc, char** argv)
         TableObject::PutById(globalObj, strArg, TValue::Create<tTable>(arg), info);
     }
 
-    const char* scriptFilename = argv[1];
+    const char* scriptFilename = argv[scriptArgIdx];
     ParseResult pr = ParseLuaScriptFromFile(vm->GetRootCoroutine(), scriptFilename);
     if (pr.m_scriptModule.get() == nullptr)
     {
@@ -60,6 +168,11 @@ static void LaunchScript(int argc, char** argv)
     }
 
     vm->LaunchScript(pr.m_scriptModule.get());
+
+    if (warmupCacheFile != nullptr && !vm->SaveBaselineJitWarmupCache(warmupCacheFile))
+    {
+        fprintf(stderr, "Warning: failed to write JIT warm-up cache file '%s'\n", warmupCacheFile);
+    }
 }
 
 int main(int argc, char** argv)
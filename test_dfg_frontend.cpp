@@ -969,3 +969,71 @@ TEST(DfgUtils, BatchedInsertion)
         }
     }
 }
+
+TEST(DfgUtils, NodeOutputInfoStorage)
+{
+    VM* vm = VM::Create();
+    Auto(vm->Destroy());
+
+    DfgAlloc()->Reset();
+
+    // Allocate nodes with every combination of direct and extra outputs back to back,
+    // so an output info array that is too short would overlap with the one allocated after it
+    //
+    std::vector<Node*> nodes;
+    for (bool hasDirectOutput : { false, true })
+    {
+        for (size_t numExtraOutputs : { 0, 1, 2, 5 })
+        {
+            for (size_t i = 0; i < 3; i++)
+            {
+                Node* node = Node::CreateNoopNode();
+                node->ResetNumOutputs(hasDirectOutput, numExtraOutputs);
+                ReleaseAssert(node->HasDirectOutput() == hasDirectOutput);
+                ReleaseAssert(node->GetNumExtraOutputs() == numExtraOutputs);
+                ReleaseAssert(node->GetNumTotalOutputs() == numExtraOutputs + (hasDirectOutput ? 1 : 0));
+                nodes.push_back(node);
+            }
+        }
+    }
+
+    std::unordered_set<Node::OutputInfo*> allOutputInfos;
+    TypeSpeculationMask val = 1;
+    for (Node* node : nodes)
+    {
+        for (uint16_t outputOrd = 0; outputOrd <= node->GetNumExtraOutputs(); outputOrd++)
+        {
+            if (!node->IsOutputOrdValid(outputOrd))
+            {
+                ReleaseAssert(outputOrd == 0 && !node->HasDirectOutput());
+                continue;
+            }
+            Node::OutputInfo* info = &node->GetOutputInfo(outputOrd);
+            ReleaseAssert(!allOutputInfos.count(info));
+            allOutputInfos.insert(info);
+            info->m_speculation = val;
+            val++;
+        }
+    }
+
+    val = 1;
+    for (Node* node : nodes)
+    {
+        if (node->HasDirectOutput())
+        {
+            ReleaseAssert(&node->GetDirectOutputInfo() == &node->GetOutputInfo(0));
+        }
+        for (uint16_t outputOrd = 1; outputOrd <= node->GetNumExtraOutputs(); outputOrd++)
+        {
+            ReleaseAssert(&node->GetExtraOutputInfo(outputOrd) == &node->GetOutputInfo(outputOrd));
+        }
+        for (uint16_t outputOrd = 0; outputOrd <= node->GetNumExtraOutputs(); outputOrd++)
+        {
+            if (node->IsOutputOrdValid(outputOrd))
+            {
+                ReleaseAssert(node->GetOutputInfo(outputOrd).m_speculation == val);
+                val++;
+            }
+        }
+    }
+}
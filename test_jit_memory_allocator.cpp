@@ -3,9 +3,15 @@
 #include "drt/jit_memory_allocator.h"
 #include "misc_math_helper.h"
 
-TEST(JITMemoryAllocator, Sanity)
+static void TestJitMemoryAllocatorSanityImpl(bool useHugePages, bool writeProtected)
 {
     JitMemoryAllocator alloc;
+    alloc.SetUseTransparentHugePages(useHugePages);
+    if (writeProtected)
+    {
+        alloc.SetIsExecutable(false);
+        alloc.SetIsWriteProtected(true);
+    }
 
     struct AllocationDesc
     {
@@ -64,6 +70,10 @@ TEST(JITMemoryAllocator, Sanity)
         {
             ptr[i] = pattern[i % 8];
         }
+        if (writeProtected)
+        {
+            alloc.WriteProtect(ptr);
+        }
 
         {
             size_t s = RoundUpToMultipleOf<16>(desc.size);
@@ -137,6 +147,10 @@ TEST(JITMemoryAllocator, Sanity)
         {
             ptr[k] = pattern[k % 8];
         }
+        if (writeProtected)
+        {
+            alloc.WriteProtect(ptr);
+        }
     }
 
     // We should not be allocating anything more from OS
@@ -154,3 +168,20 @@ TEST(JITMemoryAllocator, Sanity)
         }
     }
 }
+
+TEST(JITMemoryAllocator, Sanity)
+{
+    TestJitMemoryAllocatorSanityImpl(false /*useHugePages*/, false /*writeProtected*/);
+}
+
+TEST(JITMemoryAllocator, SanityWithHugePages)
+{
+    TestJitMemoryAllocatorSanityImpl(true /*useHugePages*/, false /*writeProtected*/);
+}
+
+TEST(JITMemoryAllocator, SanityWithWriteProtection)
+{
+    // All the writes and frees must work while the memory of the other allocations is read-only
+    //
+    TestJitMemoryAllocatorSanityImpl(false /*useHugePages*/, true /*writeProtected*/);
+}
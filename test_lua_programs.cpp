@@ -331,6 +331,36 @@ TEST(LuaTestTierUpToBaselineJit, LengthOperator)
     RunSimpleLuaTest("luatests/length_operator.lua", LuaTestOption::UpToBaselineJit);
 }
 
+TEST(LuaTest, table_length_border_hint)
+{
+    RunSimpleLuaTest("luatests/table_length_border_hint.lua", LuaTestOption::ForceInterpreter);
+}
+
+TEST(LuaTestForceBaselineJit, table_length_border_hint)
+{
+    RunSimpleLuaTest("luatests/table_length_border_hint.lua", LuaTestOption::ForceBaselineJit);
+}
+
+TEST(LuaTestTierUpToBaselineJit, table_length_border_hint)
+{
+    RunSimpleLuaTest("luatests/table_length_border_hint.lua", LuaTestOption::UpToBaselineJit);
+}
+
+TEST(LuaTest, structure_stats)
+{
+    RunSimpleLuaTest("luatests/structure_stats.lua", LuaTestOption::ForceInterpreter);
+}
+
+TEST(LuaTestForceBaselineJit, structure_stats)
+{
+    RunSimpleLuaTest("luatests/structure_stats.lua", LuaTestOption::ForceBaselineJit);
+}
+
+TEST(LuaTestTierUpToBaselineJit, structure_stats)
+{
+    RunSimpleLuaTest("luatests/structure_stats.lua", LuaTestOption::UpToBaselineJit);
+}
+
 static void LuaTest_TailCall_Impl(LuaTestOption testOption)
 {
     VM* vm = VM::Create();
@@ -950,6 +980,21 @@ TEST(LuaTestTierUpToBaselineJit, TableVariadicPut_2)
     RunSimpleLuaTest("luatests/table_variadic_put_2.lua", LuaTestOption::UpToBaselineJit);
 }
 
+TEST(LuaTest, TableVariadicPut_3)
+{
+    RunSimpleLuaTest("luatests/table_variadic_put_3.lua", LuaTestOption::ForceInterpreter);
+}
+
+TEST(LuaTestForceBaselineJit, TableVariadicPut_3)
+{
+    RunSimpleLuaTest("luatests/table_variadic_put_3.lua", LuaTestOption::ForceBaselineJit);
+}
+
+TEST(LuaTestTierUpToBaselineJit, TableVariadicPut_3)
+{
+    RunSimpleLuaTest("luatests/table_variadic_put_3.lua", LuaTestOption::UpToBaselineJit);
+}
+
 TEST(LuaTest, UpvalueClosedOnException)
 {
     RunSimpleLuaTest("luatests/upvalue_closed_on_exception.lua", LuaTestOption::ForceInterpreter);
@@ -1723,6 +1768,21 @@ TEST(LuaTestTierUpToBaselineJit, getbyid_metatable)
     RunSimpleLuaTest("luatests/getbyid_metatable.lua", LuaTestOption::UpToBaselineJit);
 }
 
+TEST(LuaTest, getbyid_index_table_ic)
+{
+    RunSimpleLuaTest("luatests/getbyid_index_table_ic.lua", LuaTestOption::ForceInterpreter);
+}
+
+TEST(LuaTestForceBaselineJit, getbyid_index_table_ic)
+{
+    RunSimpleLuaTest("luatests/getbyid_index_table_ic.lua", LuaTestOption::ForceBaselineJit);
+}
+
+TEST(LuaTestTierUpToBaselineJit, getbyid_index_table_ic)
+{
+    RunSimpleLuaTest("luatests/getbyid_index_table_ic.lua", LuaTestOption::UpToBaselineJit);
+}
+
 TEST(LuaTest, globalget_metatable)
 {
     RunSimpleLuaTest("luatests/globalget_metatable.lua", LuaTestOption::ForceInterpreter);
@@ -1873,6 +1933,21 @@ TEST(LuaTestTierUpToBaselineJit, TableGetByIdInterpreterIC)
     RunSimpleLuaTest("luatests/table_getbyid_interpreter_ic.lua", LuaTestOption::UpToBaselineJit);
 }
 
+TEST(LuaTest, TableGetMethod)
+{
+    RunSimpleLuaTest("luatests/table_get_method.lua", LuaTestOption::ForceInterpreter);
+}
+
+TEST(LuaTestForceBaselineJit, TableGetMethod)
+{
+    RunSimpleLuaTest("luatests/table_get_method.lua", LuaTestOption::ForceBaselineJit);
+}
+
+TEST(LuaTestTierUpToBaselineJit, TableGetMethod)
+{
+    RunSimpleLuaTest("luatests/table_get_method.lua", LuaTestOption::UpToBaselineJit);
+}
+
 TEST(LuaTest, GetByImmInterpreterIC_1)
 {
     RunSimpleLuaTest("luatests/get_by_imm_interpreter_ic_1.lua", LuaTestOption::ForceInterpreter);
@@ -2668,6 +2743,21 @@ TEST(LuaLibTierUpToBaselineJit, base_ipairs_2)
     RunSimpleLuaTest("luatests/base_lib_ipairs_2.lua", LuaTestOption::UpToBaselineJit);
 }
 
+TEST(LuaLib, base_ipairs_3)
+{
+    RunSimpleLuaTest("luatests/base_lib_ipairs_3.lua", LuaTestOption::ForceInterpreter);
+}
+
+TEST(LuaLibForceBaselineJit, base_ipairs_3)
+{
+    RunSimpleLuaTest("luatests/base_lib_ipairs_3.lua", LuaTestOption::ForceBaselineJit);
+}
+
+TEST(LuaLibTierUpToBaselineJit, base_ipairs_3)
+{
+    RunSimpleLuaTest("luatests/base_lib_ipairs_3.lua", LuaTestOption::UpToBaselineJit);
+}
+
 TEST(LuaLib, base_rawequal)
 {
     RunSimpleLuaTest("luatests/base_lib_rawequal.lua", LuaTestOption::ForceInterpreter);
@@ -3892,6 +3982,207 @@ TEST(LuaTestTierUp, interp_to_baseline_tier_up_3)
     TestInterpToBaselineTierUpSanity_1_Impl("luatests/interp_to_baseline_tier_up_3.lua", 2 /*numExpectedCompilations*/);
 }
 
+void TestInterpToBaselineTierUpPolicyImpl(std::string filename, VM::InterpreterTierUpPolicy policy, size_t numExpectedCompilations)
+{
+    VM* vm = VM::Create();
+    Auto(vm->Destroy());
+    vm->SetEngineStartingTier(VM::EngineStartingTier::Interpreter);
+    vm->SetEngineMaxTier(VM::EngineMaxTier::BaselineJIT);
+    vm->SetInterpreterTierUpPolicy(policy);
+    VMOutputInterceptor vmoutput(vm);
+
+    std::unique_ptr<ScriptModule> module = ParseLuaScriptOrFail(filename, LuaTestOption::UpToBaselineJit);
+    vm->LaunchScript(module.get());
+
+    std::string out = vmoutput.GetAndResetStdOut();
+    std::string err = vmoutput.GetAndResetStdErr();
+
+    AssertIsExpectedOutput(out);
+    ReleaseAssert(err == "");
+
+    ReleaseAssert(vm->GetNumTotalBaselineJitCompilations() == numExpectedCompilations);
+    ReleaseAssert(vm->GetTotalBaselineJitCompiledBytecodes() > 0 || numExpectedCompilations == 0);
+}
+
+TEST(LuaTestTierUp, interp_to_baseline_tier_up_policy_aggressive)
+{
+    TestInterpToBaselineTierUpPolicyImpl("luatests/interp_to_baseline_tier_up_1.lua", VM::InterpreterTierUpPolicy::Aggressive, 1 /*numExpectedCompilations*/);
+}
+
+TEST(LuaTestTierUp, interp_to_baseline_tier_up_policy_conservative)
+{
+    // The function is called 50 times, which is not enough to tier up under the conservative policy:
+    // each call decrements the counter by (bytecode offset of the return) + sizeof(CodeBlock), and the counter starts at
+    // 80 * (bytecode length). The function has 30 Add bytecodes, so its bytecode length is well above 2 * sizeof(CodeBlock),
+    // so it takes more than 80 * 2 / 3 > 50 calls to tier up.
+    //
+    TestInterpToBaselineTierUpPolicyImpl("luatests/interp_to_baseline_tier_up_1.lua", VM::InterpreterTierUpPolicy::Conservative, 0 /*numExpectedCompilations*/);
+}
+
+TEST(LuaTestTierUp, interp_to_baseline_tier_up_policy_adaptive)
+{
+    VM* vm = VM::Create();
+    Auto(vm->Destroy());
+    vm->SetInterpreterTierUpPolicy(VM::InterpreterTierUpPolicy::Adaptive);
+    ReleaseAssert(vm->GetInterpreterTierUpThresholdMultiplier() == x_interpreter_tier_up_threshold_bytecode_length_multiplier);
+
+    // Feed in synthetic compilation timings: the multiplier should follow the measured JIT cost per bytecode,
+    // clamped to [aggressive, conservative]
+    //
+    auto nsForMultiplier = [](size_t numBytecodes, double multiplier) -> uint64_t
+    {
+        return static_cast<uint64_t>(static_cast<double>(numBytecodes) * multiplier * x_interpreter_estimated_nanoseconds_per_bytecode);
+    };
+
+    vm->RecordBaselineJitCompilationTime(1000, nsForMultiplier(1000, 40));
+    ReleaseAssert(vm->GetInterpreterTierUpThresholdMultiplier() == 40);
+
+    // The multiplier is computed from the aggregated timing, so another 1000 bytecodes at multiplier 10 gives 25
+    //
+    vm->RecordBaselineJitCompilationTime(1000, nsForMultiplier(1000, 10));
+    ReleaseAssert(vm->GetInterpreterTierUpThresholdMultiplier() == 25);
+
+    vm->RecordBaselineJitCompilationTime(100000, nsForMultiplier(100000, 1000));
+    ReleaseAssert(vm->GetInterpreterTierUpThresholdMultiplier() == x_interpreter_tier_up_conservative_threshold_bytecode_length_multiplier);
+
+    ReleaseAssert(VM::ComputeAdaptiveInterpreterTierUpThresholdMultiplier(1000, 0) == x_interpreter_tier_up_aggressive_threshold_bytecode_length_multiplier);
+    ReleaseAssert(VM::ComputeAdaptiveInterpreterTierUpThresholdMultiplier(0, 0) == x_interpreter_tier_up_threshold_bytecode_length_multiplier);
+
+    // Per-function adjustment for recompilation: a function that was expensive to compile waits longer,
+    // and a function that was cheap to compile waits shorter, but not less than half of the global multiplier
+    //
+    vm->RecordBaselineJitCompilationTime(5000000, 0);
+    size_t globalMultiplier = vm->GetInterpreterTierUpThresholdMultiplier();
+    ReleaseAssert(globalMultiplier > x_interpreter_tier_up_aggressive_threshold_bytecode_length_multiplier * 2 && globalMultiplier < 60);
+    ReleaseAssert(vm->GetInterpreterTierUpThresholdMultiplierForRecompilation(100, nsForMultiplier(100, 60)) == 60);
+    ReleaseAssert(vm->GetInterpreterTierUpThresholdMultiplierForRecompilation(100, 0) == globalMultiplier / 2);
+
+    // Under the other policies, the measured timing does not matter
+    //
+    vm->SetInterpreterTierUpPolicy(VM::InterpreterTierUpPolicy::Conservative);
+    vm->RecordBaselineJitCompilationTime(1000, 0);
+    ReleaseAssert(vm->GetInterpreterTierUpThresholdMultiplier() == x_interpreter_tier_up_conservative_threshold_bytecode_length_multiplier);
+    ReleaseAssert(vm->GetInterpreterTierUpThresholdMultiplierForRecompilation(100, nsForMultiplier(100, 60)) == x_interpreter_tier_up_conservative_threshold_bytecode_length_multiplier);
+}
+
+TEST(LuaTestTierUp, jit_code_cache_eviction)
+{
+    VM* vm = VM::Create();
+    Auto(vm->Destroy());
+    vm->SetEngineStartingTier(VM::EngineStartingTier::Interpreter);
+    vm->SetEngineMaxTier(VM::EngineMaxTier::BaselineJIT);
+    // A limit this small means that every compilation evicts all the JIT code that is not on the stack
+    //
+    vm->SetJitCodeCacheSizeLimit(1);
+    VMOutputInterceptor vmoutput(vm);
+
+    std::unique_ptr<ScriptModule> module = ParseLuaScriptOrFail("luatests/jit_code_cache_eviction.lua", LuaTestOption::UpToBaselineJit);
+    vm->LaunchScript(module.get());
+
+    std::string out = vmoutput.GetAndResetStdOut();
+    std::string err = vmoutput.GetAndResetStdErr();
+
+    AssertIsExpectedOutput(out);
+    ReleaseAssert(err == "");
+
+    // Each of the 20 functions is evicted right after it returns, so it must tier up again in every round
+    //
+    ReleaseAssert(vm->GetNumTotalBaselineJitJettisons() > 0);
+    ReleaseAssert(vm->GetNumTotalBaselineJitCompilations() >= 60);
+}
+
+TEST(LuaTestTierUp, jit_warmup_cache)
+{
+    std::string cacheFile = "/tmp/ljr_test_jit_warmup_cache_" + std::to_string(getpid());
+    Auto(std::ignore = unlink(cacheFile.c_str()));
+
+    uint32_t numCompilationsInFirstRun;
+    {
+        VM* vm = VM::Create();
+        Auto(vm->Destroy());
+        vm->SetEngineStartingTier(VM::EngineStartingTier::Interpreter);
+        vm->SetEngineMaxTier(VM::EngineMaxTier::BaselineJIT);
+        // The cache file does not exist yet
+        //
+        ReleaseAssert(!vm->LoadBaselineJitWarmupCache(cacheFile.c_str()));
+        VMOutputInterceptor vmoutput(vm);
+
+        std::unique_ptr<ScriptModule> module = ParseLuaScriptOrFail("luatests/jit_warmup_cache.lua", LuaTestOption::UpToBaselineJit);
+        ReleaseAssert(vm->GetNumTotalBaselineJitCompilations() == 0);
+        vm->LaunchScript(module.get());
+
+        std::string out = vmoutput.GetAndResetStdOut();
+        std::string err = vmoutput.GetAndResetStdErr();
+        AssertIsExpectedOutput(out);
+        ReleaseAssert(err == "");
+
+        numCompilationsInFirstRun = vm->GetNumTotalBaselineJitCompilations();
+        ReleaseAssert(numCompilationsInFirstRun > 0);
+        ReleaseAssert(vm->SaveBaselineJitWarmupCache(cacheFile.c_str()));
+    }
+
+    {
+        VM* vm = VM::Create();
+        Auto(vm->Destroy());
+        vm->SetEngineStartingTier(VM::EngineStartingTier::Interpreter);
+        vm->SetEngineMaxTier(VM::EngineMaxTier::BaselineJIT);
+        ReleaseAssert(vm->LoadBaselineJitWarmupCache(cacheFile.c_str()));
+        VMOutputInterceptor vmoutput(vm);
+
+        // The functions compiled in the first run should be compiled right when the script is parsed,
+        // and nothing else should need to be compiled when the script runs
+        //
+        std::unique_ptr<ScriptModule> module = ParseLuaScriptOrFail("luatests/jit_warmup_cache.lua", LuaTestOption::UpToBaselineJit);
+        ReleaseAssert(vm->GetNumTotalBaselineJitCompilations() == numCompilationsInFirstRun);
+        vm->LaunchScript(module.get());
+
+        std::string out = vmoutput.GetAndResetStdOut();
+        std::string err = vmoutput.GetAndResetStdErr();
+        AssertIsExpectedOutput(out);
+        ReleaseAssert(err == "");
+
+        ReleaseAssert(vm->GetNumTotalBaselineJitCompilations() == numCompilationsInFirstRun);
+    }
+}
+
+TEST(LuaTestTierUp, perf_jit_code_map)
+{
+    std::string perfMapFile = "/tmp/perf-" + std::to_string(getpid()) + ".map";
+    std::string jitDumpFile = "/tmp/jit-" + std::to_string(getpid()) + ".dump";
+    Auto(std::ignore = unlink(perfMapFile.c_str()));
+    Auto(std::ignore = unlink(jitDumpFile.c_str()));
+
+    {
+        VM* vm = VM::Create();
+        Auto(vm->Destroy());
+        vm->SetEngineStartingTier(VM::EngineStartingTier::Interpreter);
+        vm->SetEngineMaxTier(VM::EngineMaxTier::BaselineJIT);
+        ReleaseAssert(vm->EnablePerfJitCodeMap(true /*alsoWriteJitDump*/));
+        VMOutputInterceptor vmoutput(vm);
+
+        ParseResult pr = ParseLuaScriptFromFile(vm->GetRootCoroutine(), "luatests/jit_warmup_cache.lua");
+        ReleaseAssert(pr.m_scriptModule.get() != nullptr);
+        vm->LaunchScript(pr.m_scriptModule.get());
+
+        std::string out = vmoutput.GetAndResetStdOut();
+        std::string err = vmoutput.GetAndResetStdErr();
+        AssertIsExpectedOutput(out);
+        ReleaseAssert(err == "");
+        ReleaseAssert(vm->GetNumTotalBaselineJitCompilations() > 0);
+    }
+
+    // The hot function is defined at line 1 of the script, and must have been compiled by the baseline JIT
+    //
+    std::string perfMap = LoadFile(perfMapFile);
+    ReleaseAssert(perfMap.find(" lua:luatests/jit_warmup_cache.lua:1 [baseline]\n") != std::string::npos);
+    ReleaseAssert(perfMap.find(" lua:luatests/jit_warmup_cache.lua:1 [baseline slow path]\n") != std::string::npos);
+
+    std::string jitDump = LoadFile(jitDumpFile);
+    ReleaseAssert(jitDump.length() > 40);
+    ReleaseAssert(UnalignedLoad<uint32_t>(jitDump.data()) == 0x4A695444);
+    ReleaseAssert(jitDump.find("lua:luatests/jit_warmup_cache.lua:1 [baseline]") != std::string::npos);
+}
+
 TEST(LuaTestTierUp, interp_to_baseline_osr_entry_while_loop_1)
 {
     TestInterpToBaselineTierUpSanity_1_Impl("luatests/interp_to_baseline_osr_entry_while_loop_1.lua", 1 /*numExpectedCompilations*/);
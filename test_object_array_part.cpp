@@ -666,7 +666,10 @@ TEST(ObjectArrayPart, ContinuousArray)
                                 }
                                 else
                                 {
-                                    ReleaseAssert(obj->m_butterfly->GetHeader()->m_arrayLengthIfContinuous == -1);
+                                    // The header holds a border hint instead of the length
+                                    //
+                                    ReleaseAssert(!obj->m_butterfly->GetHeader()->IsContinuous());
+                                    ReleaseAssert(!obj->m_butterfly->GetHeader()->HasSparseMap());
                                 }
                             }
                             ReleaseAssert(arrType.ArrayKind() == expectNewKind);
@@ -424,4 +424,76 @@ TEST(ObjectGetPutById, MissedGetByIdIsUncacheableForCacheableDicitonary)
     }
 }
 
+// The megamorphic property cache must always agree with the uncached lookup, for both Structures and CacheableDictionaries
+//
+TEST(ObjectGetPutById, MegamorphicPropertyCache)
+{
+    VM* vm = VM::Create();
+    Auto(vm->Destroy());
+    const uint32_t numStrings = 64;
+    StringList strings = GetStringList(VM::GetActiveVMForCurrentThread(), numStrings);
+    Structure* initStructure = Structure::CreateInitialStructure(VM::GetActiveVMForCurrentThread(), 4 /*inlineCapacity*/);
+
+    auto checkGetByIdAgrees = [&](HeapPtr<TableObject> obj, UserHeapPointer<HeapString> prop)
+    {
+        GetByIdICInfo expected;
+        TableObject::PrepareGetById(obj, prop, expected /*out*/);
+        // Query twice, so that both the cache-miss path and the cache-hit path are tested
+        //
+        for (uint32_t k = 0; k < 2; k++)
+        {
+            GetByIdICInfo actual;
+            TableObject::PrepareGetByIdWithMegamorphicCache(obj, prop, actual /*out*/);
+            ReleaseAssert(actual.m_icKind == expected.m_icKind);
+            ReleaseAssert(actual.m_mayHaveMetatable == expected.m_mayHaveMetatable);
+            if (expected.m_icKind == GetByIdICInfo::ICKind::InlinedStorage || expected.m_icKind == GetByIdICInfo::ICKind::OutlinedStorage)
+            {
+                ReleaseAssert(actual.m_slot == expected.m_slot);
+            }
+        }
+    };
+
+    uint32_t numTestCases = x_isDebugBuild ? 200 : 1000;
+    for (uint32_t testCase = 0; testCase < numTestCases; testCase++)
+    {
+        // Insert properties in random order so that we get lots of different structures
+        //
+        HeapPtr<TableObject> curObject = TableObject::CreateEmptyTableObject(vm, initStructure, 0 /*initArraySize*/);
+        uint32_t numProps = static_cast<uint32_t>(rand()) % 12 + 1;
+        std::set<int64_t> usedProps;
+        for (uint32_t i = 0; i < numProps; i++)
+        {
+            UserHeapPointer<HeapString> propToAdd = strings[static_cast<size_t>(rand()) % strings.size()];
+            PutByIdICInfo icInfo;
+            TableObject::PreparePutByIdWithMegamorphicCache(curObject, propToAdd, icInfo /*out*/);
+            ReleaseAssert(icInfo.m_propertyExists == (usedProps.count(propToAdd.m_value) > 0));
+            usedProps.insert(propToAdd.m_value);
+            TableObject::PutById(curObject, propToAdd.As<void>(), TValue::CreateInt32(static_cast<int32_t>(i)), icInfo);
+
+            checkGetByIdAgrees(curObject, propToAdd);
+            checkGetByIdAgrees(curObject, strings[static_cast<size_t>(rand()) % strings.size()]);
+        }
+    }
+
+    // Now test a CacheableDictionary, which must bypass the cache
+    //
+    HeapPtr<TableObject> dictObject = TableObject::CreateEmptyTableObject(vm, initStructure, 0 /*initArraySize*/);
+    StringList manyStrings = GetStringList(VM::GetActiveVMForCurrentThread(), 500);
+    for (uint32_t i = 0; i < 500; i++)
+    {
+        PutByIdICInfo icInfo;
+        TableObject::PreparePutByIdWithMegamorphicCache(dictObject, manyStrings[i], icInfo /*out*/);
+        TableObject::PutById(dictObject, manyStrings[i].As<void>(), TValue::CreateInt32(static_cast<int32_t>(i)), icInfo);
+    }
+    ReleaseAssert(TCGet(dictObject->m_hiddenClass).As<SystemHeapGcObjectHeader>()->m_type == HeapEntityType::CacheableDictionary);
+    for (uint32_t i = 0; i < 500; i += 7)
+    {
+        checkGetByIdAgrees(dictObject, manyStrings[i]);
+        GetByIdICInfo icInfo;
+        TableObject::PrepareGetByIdWithMegamorphicCache(dictObject, manyStrings[i], icInfo /*out*/);
+        TValue result = TableObject::GetById(dictObject, manyStrings[i].As<void>(), icInfo);
+        ReleaseAssert(result.IsInt32() && result.AsInt32() == static_cast<int32_t>(i));
+    }
+}
+
 }   // anonymous namespace
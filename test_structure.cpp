@@ -611,4 +611,119 @@ TEST(Structure, ArrayTypeTransition)
     DoArrayTypeTransitionTest(400 /*numStrings*/, 1500 /*numNodes*/, 3 /*degreeParam*/);
 }
 
+TEST(Structure, TransitionFanOutGuard)
+{
+    VM* vm = VM::Create();
+    Auto(vm->Destroy());
+
+    constexpr uint32_t threshold = Structure::x_transitionFanOutGuardThreshold;
+    StringList strings = GetStringList(vm, threshold + 10);
+
+    Structure* initStructure = Structure::CreateInitialStructure(vm, 2 /*initialInlineCap*/);
+    ReleaseAssert(vm->GetStructureStats().m_numStructuresCreated > 0);
+
+    Structure* base;
+    {
+        Structure::AddNewPropertyResult result;
+        initStructure->AddNonExistentProperty(vm, strings[0].As<void>(), result /*out*/);
+        ReleaseAssert(!result.m_shouldTransitionToDictionaryMode);
+        base = reinterpret_cast<Structure*>(result.m_newStructure);
+    }
+
+    VM::StructureStats oldStats = vm->GetStructureStats();
+
+    // The first 'threshold' transitions out of 'base' are created normally
+    //
+    std::vector<Structure*> children;
+    for (uint32_t i = 1; i <= threshold; i++)
+    {
+        Structure::AddNewPropertyResult result;
+        base->AddNonExistentProperty(vm, strings[i].As<void>(), result /*out*/);
+        ReleaseAssert(!result.m_shouldTransitionToDictionaryMode);
+        children.push_back(reinterpret_cast<Structure*>(result.m_newStructure));
+    }
+    ReleaseAssert(base->GetNumTransitions(vm) == threshold);
+
+    VM::StructureStats stats = vm->GetStructureStats();
+    ReleaseAssert(stats.m_numStructuresCreated == oldStats.m_numStructuresCreated + threshold);
+    ReleaseAssert(stats.m_numTransitionsCreated == oldStats.m_numTransitionsCreated + threshold);
+    ReleaseAssert(stats.m_maxTransitionFanOut >= threshold);
+    ReleaseAssert(stats.m_numDictionaryConversionsDueToFanOut == oldStats.m_numDictionaryConversionsDueToFanOut);
+
+    // Further new transitions out of 'base' should request dictionary mode
+    //
+    for (uint32_t i = threshold + 1; i < strings.size(); i++)
+    {
+        Structure::AddNewPropertyResult result;
+        base->AddNonExistentProperty(vm, strings[i].As<void>(), result /*out*/);
+        ReleaseAssert(result.m_shouldTransitionToDictionaryMode);
+    }
+    ReleaseAssert(base->GetNumTransitions(vm) == threshold);
+    ReleaseAssert(vm->GetStructureStats().m_numStructuresCreated == stats.m_numStructuresCreated);
+    ReleaseAssert(vm->GetStructureStats().m_numDictionaryConversionsDueToFanOut == stats.m_numDictionaryConversionsDueToFanOut + (strings.size() - threshold - 1));
+
+    // But existing transitions are still taken
+    //
+    for (uint32_t i = 1; i <= threshold; i++)
+    {
+        Structure::AddNewPropertyResult result;
+        base->AddNonExistentProperty(vm, strings[i].As<void>(), result /*out*/);
+        ReleaseAssert(!result.m_shouldTransitionToDictionaryMode);
+        ReleaseAssert(result.m_newStructure == children[i - 1]);
+    }
+}
+
+TEST(Structure, TransitionFanOutGuardOnlyLooksAtSourceNode)
+{
+    VM* vm = VM::Create();
+    Auto(vm->Destroy());
+
+    constexpr uint32_t threshold = Structure::x_transitionFanOutGuardThreshold;
+    StringList strings = GetStringList(vm, threshold + 50);
+
+    auto addProperty = [&](Structure* structure, uint32_t ord) -> Structure*
+    {
+        Structure::AddNewPropertyResult result;
+        structure->AddNonExistentProperty(vm, strings[ord].As<void>(), result /*out*/);
+        ReleaseAssert(!result.m_shouldTransitionToDictionaryMode);
+        return reinterpret_cast<Structure*>(result.m_newStructure);
+    };
+
+    Structure* initStructure = Structure::CreateInitialStructure(vm, 2 /*initialInlineCap*/);
+    Structure* base = addProperty(initStructure, 0);
+
+    // Make 'base' fan out up to the threshold
+    //
+    std::vector<Structure*> children;
+    for (uint32_t i = 1; i <= threshold; i++)
+    {
+        children.push_back(addProperty(base, i));
+    }
+    ReleaseAssert(base->ShouldTransitionToDictionaryDueToFanOut(vm));
+
+    uint64_t numFanOutDictionaries = vm->GetStructureStats().m_numDictionaryConversionsDueToFanOut;
+
+    // A chain hanging off one of the children only transitions from nodes with a single outgoing edge,
+    // so every node on it must still get a Structure, even though it descends from the saturated 'base'
+    //
+    Structure* cur = children[0];
+    for (uint32_t i = threshold + 1; i < strings.size(); i++)
+    {
+        ReleaseAssert(!cur->ShouldTransitionToDictionaryDueToFanOut(vm));
+        Structure* next = addProperty(cur, i);
+        ReleaseAssert(next != cur);
+        ReleaseAssert(cur->GetNumTransitions(vm) == 1);
+        cur = next;
+    }
+
+    // The other children can also grow new properties, since each of them only has at most one outgoing transition
+    //
+    for (size_t k = 1; k < children.size(); k++)
+    {
+        std::ignore = addProperty(children[k], threshold + 1);
+    }
+
+    ReleaseAssert(vm->GetStructureStats().m_numDictionaryConversionsDueToFanOut == numFanOutDictionaries);
+}
+
 }   // anonymous namespace